@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/**
+ * @brief Helpers for the microbenchmarks in the benchmark-soccer target.
+ *
+ * @details Benchmarks are written as gtest cases so they can be filtered like
+ * the unit tests.  They should be built in release mode (`make benchmarks`) for
+ * the numbers to mean anything.
+ *
+ * Use Example:
+ * double ns = Benchmark::nsPerIteration(100000, [&](int i) { f(i); });
+ * Benchmark::report("f()", ns);
+ */
+namespace Benchmark {
+
+/// Keeps the compiler from optimizing away the computation of @value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Calls @f with the indices 0 to @iterations - 1, after a short warmup, and
+ * returns the mean wall-clock time per call in nanoseconds.
+ */
+template <typename F>
+double nsPerIteration(int iterations, F&& f) {
+    for (int i = 0; i < iterations / 10; i++) {
+        f(i);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        f(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           iterations;
+}
+
+/// Prints one line of benchmark results
+inline void report(const std::string& name, double nsPerIteration) {
+    printf("[ BENCH    ] %-48s %12.1f ns\n", name.c_str(), nsPerIteration);
+}
+
+}  // namespace Benchmark
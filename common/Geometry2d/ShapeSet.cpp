@@ -0,0 +1,191 @@
+#include "ShapeSet.hpp"
+#include "Circle.hpp"
+#include "CompositeShape.hpp"
+#include "Polygon.hpp"
+#include "Rect.hpp"
+#include "Segment.hpp"
+#include <Constants.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace Geometry2d {
+
+namespace {
+
+// Shapes are bucketed into cells of this size (in meters), unless that would
+// make the grid larger than MaxGridDim cells along an axis.
+constexpr double DefaultCellSize = 0.5;
+constexpr int MaxGridDim = 64;
+
+// Shapes that would be stored in more cells than this are checked on every
+// query instead.
+constexpr int MaxShapeCells = 64;
+
+// Extra padding on each bounding box so that float rounding in the shapes' own
+// hit() tests can never make the index miss a collision
+constexpr double BoundsMargin = 1e-3;
+
+constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+}  // namespace
+
+/// Bounding box of everything that @shape can hit, or an infinite box if that
+/// isn't known
+static void shapeBounds(const Shape& shape, double& minX, double& minY,
+                        double& maxX, double& maxY) {
+    minX = minY = Infinity;
+    maxX = maxY = -Infinity;
+
+    if (auto circle = dynamic_cast<const Circle*>(&shape)) {
+        const double r = circle->radius();
+        minX = circle->center.x() - r;
+        minY = circle->center.y() - r;
+        maxX = circle->center.x() + r;
+        maxY = circle->center.y() + r;
+    } else if (auto rect = dynamic_cast<const Rect*>(&shape)) {
+        minX = rect->minx();
+        minY = rect->miny();
+        maxX = rect->maxx();
+        maxY = rect->maxy();
+    } else if (auto polygon = dynamic_cast<const Polygon*>(&shape)) {
+        for (Point vertex : polygon->vertices) {
+            minX = std::min(minX, vertex.x());
+            minY = std::min(minY, vertex.y());
+            maxX = std::max(maxX, vertex.x());
+            maxY = std::max(maxY, vertex.y());
+        }
+    } else if (auto composite = dynamic_cast<const CompositeShape*>(&shape)) {
+        for (const auto& subshape : composite->subshapes()) {
+            double subMinX, subMinY, subMaxX, subMaxY;
+            shapeBounds(*subshape, subMinX, subMinY, subMaxX, subMaxY);
+            minX = std::min(minX, subMinX);
+            minY = std::min(minY, subMinY);
+            maxX = std::max(maxX, subMaxX);
+            maxY = std::max(maxY, subMaxY);
+        }
+        // An empty composite can't hit anything, so its empty box is correct
+        return;
+    } else {
+        minX = minY = -Infinity;
+        maxX = maxY = Infinity;
+        return;
+    }
+
+    const double grow = Robot_Radius + BoundsMargin;
+    minX -= grow;
+    minY -= grow;
+    maxX += grow;
+    maxY += grow;
+}
+
+ShapeSet::Bounds ShapeSet::queryBounds(const Segment& seg) {
+    return Bounds{std::min(seg.pt[0].x(), seg.pt[1].x()),
+                  std::min(seg.pt[0].y(), seg.pt[1].y()),
+                  std::max(seg.pt[0].x(), seg.pt[1].x()),
+                  std::max(seg.pt[0].y(), seg.pt[1].y())};
+}
+
+ShapeSet::CellRange ShapeSet::Index::cellRange(const Bounds& b) const {
+    // Clamp before converting so huge boxes can't overflow an int
+    auto toCell = [this](double value, double origin, int dim) {
+        const double cell = std::floor((value - origin) / cellSize);
+        return static_cast<int>(std::max(-1.0, std::min(cell, double(dim))));
+    };
+    return CellRange{toCell(b.minX, originX, cols), toCell(b.minY, originY, rows),
+                     toCell(b.maxX, originX, cols),
+                     toCell(b.maxY, originY, rows)};
+}
+
+ShapeSet::Index::Index(const std::vector<std::shared_ptr<Shape>>& shapes) {
+    bounds.resize(shapes.size());
+
+    double minX = Infinity, minY = Infinity;
+    double maxX = -Infinity, maxY = -Infinity;
+    for (uint32_t i = 0; i < shapes.size(); i++) {
+        Bounds& b = bounds[i];
+        shapeBounds(*shapes[i], b.minX, b.minY, b.maxX, b.maxY);
+
+        if (std::isfinite(b.minX) && std::isfinite(b.minY) &&
+            std::isfinite(b.maxX) && std::isfinite(b.maxY)) {
+            indexed.push_back(i);
+            minX = std::min(minX, b.minX);
+            minY = std::min(minY, b.minY);
+            maxX = std::max(maxX, b.maxX);
+            maxY = std::max(maxY, b.maxY);
+        } else if (b.minX <= b.maxX && b.minY <= b.maxY) {
+            unindexed.push_back(i);
+        }
+        // Otherwise the box is empty and the shape can never be hit
+    }
+
+    if (indexed.empty()) {
+        return;
+    }
+
+    const double width = maxX - minX;
+    const double height = maxY - minY;
+    cellSize = std::max({DefaultCellSize, width / MaxGridDim,
+                         height / MaxGridDim});
+    originX = minX;
+    originY = minY;
+    cols = std::min(MaxGridDim, static_cast<int>(width / cellSize) + 1);
+    rows = std::min(MaxGridDim, static_cast<int>(height / cellSize) + 1);
+
+    // Move shapes that cover too much of the grid to the unindexed list, then
+    // fill the grid in two passes: count the shapes in each cell, then place
+    // them.
+    std::vector<uint32_t> gridded;
+    gridded.reserve(indexed.size());
+    for (uint32_t i : indexed) {
+        CellRange range = cellRange(bounds[i]);
+        range.maxX = std::min(range.maxX, cols - 1);
+        range.maxY = std::min(range.maxY, rows - 1);
+        if (range.count() > MaxShapeCells) {
+            unindexed.push_back(i);
+        } else {
+            gridded.push_back(i);
+        }
+    }
+    indexed.swap(gridded);
+
+    cellStart.assign(cols * rows + 1, 0);
+    auto forEachCell = [this](uint32_t i, auto&& f) {
+        CellRange range = cellRange(bounds[i]);
+        range.maxX = std::min(range.maxX, cols - 1);
+        range.maxY = std::min(range.maxY, rows - 1);
+        for (int y = range.minY; y <= range.maxY; y++) {
+            for (int x = range.minX; x <= range.maxX; x++) {
+                f(y * cols + x);
+            }
+        }
+    };
+
+    for (uint32_t i : indexed) {
+        forEachCell(i, [this](int cell) { cellStart[cell + 1]++; });
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    cellShapes.resize(cellStart.back());
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (uint32_t i : indexed) {
+        forEachCell(i, [&](int cell) { cellShapes[fill[cell]++] = i; });
+    }
+}
+
+const ShapeSet::Index& ShapeSet::buildIndex() const {
+    auto built = std::make_shared<const Index>(_shapes);
+
+    // If another thread finished building first, use its index instead
+    std::shared_ptr<const Index> expected;
+    if (!std::atomic_compare_exchange_strong(&_index, &expected, built)) {
+        built = expected;
+    }
+
+    _indexPtr.store(built.get(), std::memory_order_release);
+    return *built;
+}
+
+}  // namespace Geometry2d
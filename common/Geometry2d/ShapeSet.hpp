@@ -2,16 +2,37 @@
 
 #include "Shape.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
-#include <set>
 #include <sstream>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 namespace Geometry2d {
 
+class Segment;
+
 /// This class maintains a collection of Shape objects.
+///
+/// Collision queries go through a spatial index: every shape gets a bounding
+/// box (grown by Robot_Radius, like Shape::hit()) and the boxes are bucketed
+/// into a uniform grid.  Only shapes whose boxes overlap the query are tested
+/// with their (virtual) hit() method.  The index is built on the first query
+/// after the set changes and is shared between copies of the set, so copying
+/// a ShapeSet stays cheap.
+///
+/// Shapes must not be modified after they are added to the set, or the index
+/// will go stale.  Like the standard containers, a ShapeSet may be queried
+/// from several threads at once but not modified while it is being queried.
 class ShapeSet {
 public:
+    /// Shapes hit by a collision query.  The first few are stored inline so
+    /// that typical queries don't allocate.
+    using HitSet = boost::container::small_vector<const Shape*, 8>;
+
     ShapeSet() {}
 
     /// Initializes the set by iterating from @first to @last, which are
@@ -23,37 +44,62 @@ public:
         }
     }
 
-    std::vector<std::shared_ptr<Shape>> shapes() { return _shapes; }
-    const std::vector<std::shared_ptr<Shape>> shapes() const { return _shapes; }
+    ShapeSet(const ShapeSet& other)
+        : _shapes(other._shapes), _index(std::atomic_load(&other._index)) {
+        _indexPtr.store(_index.get(), std::memory_order_release);
+    }
+
+    ShapeSet& operator=(const ShapeSet& other) {
+        if (this != &other) {
+            _shapes = other._shapes;
+            _index = std::atomic_load(&other._index);
+            _indexPtr.store(_index.get(), std::memory_order_release);
+        }
+        return *this;
+    }
+
+    const std::vector<std::shared_ptr<Shape>>& shapes() const {
+        return _shapes;
+    }
 
     void add(std::shared_ptr<Shape> shape) {
         assert(shape != nullptr);
         _shapes.push_back(shape);
+        invalidateIndex();
     }
 
     void add(const ShapeSet& other) {
-        for (auto shape : other.shapes()) {
-            add(shape);
+        // By index after reserving, so that adding a set to itself doesn't
+        // read from storage the insert has reallocated
+        const size_t count = other._shapes.size();
+        _shapes.reserve(_shapes.size() + count);
+        for (size_t i = 0; i < count; i++) {
+            _shapes.push_back(other._shapes[i]);
         }
+        invalidateIndex();
     }
 
     /// Remove all shapes
-    void clear() { _shapes.clear(); }
+    void clear() {
+        _shapes.clear();
+        invalidateIndex();
+    }
 
     /**
      * Get a set of which shapes "hit" the given object.
      *
      * @param obj The object to collision test
-     * @return A set of all shapes that collide with the given object
+     * @return All shapes that collide with the given object
      */
     template <typename T>
-    std::set<std::shared_ptr<Shape>> hitSet(const T& obj) const {
-        std::set<std::shared_ptr<Shape>> hits;
-        for (const auto& shape : _shapes) {
-            if (shape->hit(obj)) {
-                hits.insert(shape);
+    HitSet hitSet(const T& obj) const {
+        HitSet hits;
+        forEachCandidate(queryBounds(obj), [&](const Shape& shape) {
+            if (shape.hit(obj)) {
+                hits.push_back(&shape);
             }
-        }
+            return false;
+        });
         return hits;
     }
 
@@ -65,7 +111,12 @@ public:
      */
     template <typename T>
     bool hit(const T& obj) const {
-        return !hitSet<T>(obj).empty();
+        bool hitAny = false;
+        forEachCandidate(queryBounds(obj), [&](const Shape& shape) {
+            hitAny = shape.hit(obj);
+            return hitAny;
+        });
+        return hitAny;
     }
 
     friend std::ostream& operator<<(std::ostream& out,
@@ -79,7 +130,141 @@ public:
     }
 
 private:
+    /// Axis-aligned bounding box
+    struct Bounds {
+        double minX, minY, maxX, maxY;
+
+        bool overlaps(const Bounds& other) const {
+            return minX <= other.maxX && other.minX <= maxX &&
+                   minY <= other.maxY && other.minY <= maxY;
+        }
+    };
+
+    /// Range of grid cells covered by a bounding box, inclusive
+    struct CellRange {
+        int minX, minY, maxX, maxY;
+
+        int count() const { return (maxX - minX + 1) * (maxY - minY + 1); }
+    };
+
+    /// Immutable search structure over the shapes of a ShapeSet
+    struct Index {
+        explicit Index(const std::vector<std::shared_ptr<Shape>>& shapes);
+
+        CellRange cellRange(const Bounds& bounds) const;
+
+        /// Bounding box of each shape, in the same order as the shapes
+        std::vector<Bounds> bounds;
+
+        /// Shapes that are checked on every query, either because they don't
+        /// have a finite bounding box or because they cover most of the grid
+        std::vector<uint32_t> unindexed;
+
+        /// Shapes that are bucketed into the grid
+        std::vector<uint32_t> indexed;
+
+        /// Uniform grid over the bounding boxes of the indexed shapes.  The
+        /// shapes overlapping cell c are
+        /// cellShapes[cellStart[c]] ... cellShapes[cellStart[c + 1] - 1].
+        double originX = 0, originY = 0;
+        double cellSize = 1;
+        int cols = 0, rows = 0;
+        std::vector<uint32_t> cellStart;
+        std::vector<uint32_t> cellShapes;
+    };
+
+    /// Queries covering more cells than this scan the indexed shapes linearly
+    static constexpr int MaxQueryCells = 16;
+
+    static Bounds queryBounds(Point pt) {
+        return Bounds{pt.x(), pt.y(), pt.x(), pt.y()};
+    }
+
+    static Bounds queryBounds(const Segment& seg);
+
+    /// Calls @visit with each shape whose bounding box overlaps @query, at most
+    /// once per shape, until @visit returns true.
+    template <typename F>
+    void forEachCandidate(const Bounds& query, F&& visit) const {
+        if (_shapes.empty()) {
+            return;
+        }
+        const Index& idx = index();
+
+        for (uint32_t i : idx.unindexed) {
+            if (idx.bounds[i].overlaps(query) && visit(*_shapes[i])) {
+                return;
+            }
+        }
+
+        if (idx.indexed.empty()) {
+            return;
+        }
+
+        CellRange range = idx.cellRange(query);
+        range.minX = std::max(range.minX, 0);
+        range.minY = std::max(range.minY, 0);
+        range.maxX = std::min(range.maxX, idx.cols - 1);
+        range.maxY = std::min(range.maxY, idx.rows - 1);
+        if (range.minX > range.maxX || range.minY > range.maxY) {
+            // Every indexed shape lies inside the grid
+            return;
+        }
+
+        if (range.count() > MaxQueryCells) {
+            for (uint32_t i : idx.indexed) {
+                if (idx.bounds[i].overlaps(query) && visit(*_shapes[i])) {
+                    return;
+                }
+            }
+            return;
+        }
+
+        for (int y = range.minY; y <= range.maxY; y++) {
+            for (int x = range.minX; x <= range.maxX; x++) {
+                const int cell = y * idx.cols + x;
+                for (uint32_t k = idx.cellStart[cell];
+                     k < idx.cellStart[cell + 1]; k++) {
+                    const uint32_t i = idx.cellShapes[k];
+                    const Bounds& bounds = idx.bounds[i];
+
+                    // A shape can span several of the query's cells.  Only
+                    // visit it from the first cell that the two share.
+                    const CellRange shapeRange = idx.cellRange(bounds);
+                    if (std::max(shapeRange.minX, range.minX) != x ||
+                        std::max(shapeRange.minY, range.minY) != y) {
+                        continue;
+                    }
+
+                    if (bounds.overlaps(query) && visit(*_shapes[i])) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    const Index& index() const {
+        const Index* idx = _indexPtr.load(std::memory_order_acquire);
+        return idx ? *idx : buildIndex();
+    }
+
+    const Index& buildIndex() const;
+
+    void invalidateIndex() {
+        _index.reset();
+        _indexPtr.store(nullptr, std::memory_order_release);
+    }
+
     std::vector<std::shared_ptr<Shape>> _shapes;
+
+    /// Lazily-built search structure.  Shared with copies of this set until
+    /// one of them is modified.
+    mutable std::shared_ptr<const Index> _index;
+
+    /// Raw pointer to *_index, published once the index is built so queries
+    /// don't touch the shared_ptr's reference count
+    mutable std::atomic<const Index*> _indexPtr{nullptr};
 };
 
 }  // namespace Geometry2d
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <Benchmark.hpp>
+#include "Circle.hpp"
+#include "Rect.hpp"
+#include "Segment.hpp"
+#include "ShapeSet.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace Geometry2d;
+using namespace std;
+
+namespace {
+
+/// Obstacles like the ones the planner sees: robots, plus a few rectangles
+/// for the goal zones and field walls
+ShapeSet fieldObstacles(mt19937& gen, int count) {
+    uniform_real_distribution<float> x(-3, 3);
+    uniform_real_distribution<float> y(0, 9);
+
+    ShapeSet shapes;
+    for (int i = 0; i < count; i++) {
+        if (i % 10 == 0) {
+            Point corner(x(gen), y(gen));
+            shapes.add(make_shared<Rect>(corner, corner + Point(1.2, 0.6)));
+        } else {
+            shapes.add(make_shared<Circle>(Point(x(gen), y(gen)), 0.09));
+        }
+    }
+    return shapes;
+}
+
+/// Short segments like the ones an RRT checks when extending its tree
+vector<Segment> querySegments(mt19937& gen, int count) {
+    uniform_real_distribution<float> x(-3, 3);
+    uniform_real_distribution<float> y(0, 9);
+    uniform_real_distribution<float> step(-0.15, 0.15);
+
+    vector<Segment> segments;
+    for (int i = 0; i < count; i++) {
+        Point start(x(gen), y(gen));
+        segments.emplace_back(start, start + Point(step(gen), step(gen)));
+    }
+    return segments;
+}
+
+}  // namespace
+
+TEST(ShapeSetBenchmark, segmentQueries) {
+    mt19937 gen(1);
+    const vector<Segment> segments = querySegments(gen, 4096);
+
+    for (int count : {12, 32, 64, 128}) {
+        const ShapeSet shapes = fieldObstacles(gen, count);
+        const auto& all = shapes.shapes();
+        const string suffix = " (" + to_string(count) + " obstacles)";
+
+        Benchmark::report(
+            "linear scan" + suffix,
+            Benchmark::nsPerIteration(200000, [&](int i) {
+                const Segment& seg = segments[i % segments.size()];
+                bool hit = false;
+                for (const auto& shape : all) {
+                    if (shape->hit(seg)) {
+                        hit = true;
+                        break;
+                    }
+                }
+                Benchmark::doNotOptimize(hit);
+            }));
+
+        Benchmark::report(
+            "ShapeSet::hit" + suffix,
+            Benchmark::nsPerIteration(200000, [&](int i) {
+                Benchmark::doNotOptimize(
+                    shapes.hit(segments[i % segments.size()]));
+            }));
+
+        Benchmark::report(
+            "ShapeSet::hitSet" + suffix,
+            Benchmark::nsPerIteration(200000, [&](int i) {
+                Benchmark::doNotOptimize(
+                    shapes.hitSet(segments[i % segments.size()]).size());
+            }));
+    }
+}
+
+TEST(ShapeSetBenchmark, transitionChecks) {
+    // The check RoboCupStateSpace::transitionValid() makes for each RRT step
+    mt19937 gen(2);
+    const vector<Segment> segments = querySegments(gen, 4096);
+
+    for (int count : {12, 32, 64}) {
+        const ShapeSet shapes = fieldObstacles(gen, count);
+        const string suffix = " (" + to_string(count) + " obstacles)";
+
+        Benchmark::report(
+            "ShapeSet::hitSet transition" + suffix,
+            Benchmark::nsPerIteration(200000, [&](int i) {
+                const Segment& seg = segments[i % segments.size()];
+                bool valid = true;
+                for (const Shape* shape : shapes.hitSet(seg)) {
+                    if (!shape->hit(seg.pt[0])) {
+                        valid = false;
+                        break;
+                    }
+                }
+                Benchmark::doNotOptimize(valid);
+            }));
+    }
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "Circle.hpp"
+#include "CompositeShape.hpp"
+#include "Polygon.hpp"
+#include "Rect.hpp"
+#include "Segment.hpp"
+#include "ShapeSet.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Geometry2d;
+using namespace std;
+
+namespace {
+
+/// Fills a set with a mix of random shapes scattered over (and a bit beyond)
+/// the field
+ShapeSet randomShapeSet(mt19937& gen, int count) {
+    uniform_real_distribution<float> pos(-6, 6);
+    uniform_real_distribution<float> size(0.05, 1.5);
+
+    ShapeSet shapes;
+    for (int i = 0; i < count; i++) {
+        Point center(pos(gen), pos(gen));
+        switch (i % 4) {
+            case 0:
+                shapes.add(make_shared<Circle>(center, size(gen)));
+                break;
+            case 1:
+                shapes.add(make_shared<Rect>(
+                    center, center + Point(size(gen), size(gen))));
+                break;
+            case 2:
+                shapes.add(make_shared<Polygon>(vector<Point>{
+                    center, center + Point(size(gen), 0),
+                    center + Point(0, size(gen))}));
+                break;
+            case 3: {
+                auto composite = make_shared<CompositeShape>();
+                composite->add(make_shared<Circle>(center, size(gen)));
+                composite->add(make_shared<Circle>(
+                    Point(pos(gen), pos(gen)), size(gen)));
+                shapes.add(composite);
+                break;
+            }
+        }
+    }
+    return shapes;
+}
+
+/// The shapes in @shapes that hit @obj, found by testing every one
+template <typename T>
+vector<const Shape*> bruteForceHits(const ShapeSet& shapes, const T& obj) {
+    vector<const Shape*> hits;
+    for (const auto& shape : shapes.shapes()) {
+        if (shape->hit(obj)) {
+            hits.push_back(shape.get());
+        }
+    }
+    sort(hits.begin(), hits.end());
+    return hits;
+}
+
+template <typename T>
+vector<const Shape*> sortedHitSet(const ShapeSet& shapes, const T& obj) {
+    ShapeSet::HitSet hitSet = shapes.hitSet(obj);
+    vector<const Shape*> hits(hitSet.begin(), hitSet.end());
+    sort(hits.begin(), hits.end());
+    return hits;
+}
+
+}  // namespace
+
+TEST(ShapeSet, matchesBruteForce) {
+    mt19937 gen(1);
+    uniform_real_distribution<float> pos(-8, 8);
+
+    for (int count : {0, 1, 5, 40, 200}) {
+        ShapeSet shapes = randomShapeSet(gen, count);
+        for (int i = 0; i < 500; i++) {
+            Point pt(pos(gen), pos(gen));
+            EXPECT_EQ(bruteForceHits(shapes, pt), sortedHitSet(shapes, pt));
+            EXPECT_EQ(!bruteForceHits(shapes, pt).empty(), shapes.hit(pt));
+
+            // Mostly short segments, like the RRT's, plus some long ones
+            Point end = (i % 5 == 0) ? Point(pos(gen), pos(gen))
+                                     : pt + Point(pos(gen), pos(gen)) / 20;
+            Segment seg(pt, end);
+            EXPECT_EQ(bruteForceHits(shapes, seg), sortedHitSet(shapes, seg));
+            EXPECT_EQ(!bruteForceHits(shapes, seg).empty(), shapes.hit(seg));
+        }
+    }
+}
+
+TEST(ShapeSet, hugeShape) {
+    ShapeSet shapes;
+    auto big = make_shared<Rect>(Point(-1000, -1000), Point(1000, 1000));
+    auto small = make_shared<Circle>(Point(0, 0), 0.1);
+    shapes.add(big);
+    shapes.add(small);
+
+    EXPECT_EQ(2, shapes.hitSet(Point(0, 0)).size());
+    EXPECT_EQ(1, shapes.hitSet(Point(500, 500)).size());
+    EXPECT_FALSE(shapes.hit(Point(2000, 0)));
+}
+
+TEST(ShapeSet, modifiedAfterQuery) {
+    ShapeSet shapes;
+    shapes.add(make_shared<Circle>(Point(0, 0), 0.5));
+    EXPECT_TRUE(shapes.hit(Point(0, 0)));
+    EXPECT_FALSE(shapes.hit(Point(3, 3)));
+
+    // Copies share the index until one of them changes
+    ShapeSet copy = shapes;
+    copy.add(make_shared<Circle>(Point(3, 3), 0.5));
+    EXPECT_TRUE(copy.hit(Point(3, 3)));
+    EXPECT_FALSE(shapes.hit(Point(3, 3)));
+
+    shapes.add(copy);
+    EXPECT_EQ(3, shapes.shapes().size());
+    EXPECT_TRUE(shapes.hit(Point(3, 3)));
+
+    shapes.clear();
+    EXPECT_FALSE(shapes.hit(Point(0, 0)));
+    EXPECT_TRUE(shapes.hitSet(Segment(Point(-5, 0), Point(5, 0))).empty());
+}
+
+TEST(ShapeSet, addSelf) {
+    ShapeSet shapes;
+    shapes.add(make_shared<Circle>(Point(0, 0), 0.5));
+    shapes.add(make_shared<Circle>(Point(3, 3), 0.5));
+    EXPECT_EQ(2, shapes.hitSet(Segment(Point(0, 0), Point(3, 3))).size());
+
+    shapes.add(shapes);
+    ASSERT_EQ(4, shapes.shapes().size());
+    EXPECT_EQ(shapes.shapes()[0], shapes.shapes()[2]);
+    EXPECT_EQ(shapes.shapes()[1], shapes.shapes()[3]);
+    EXPECT_EQ(4, shapes.hitSet(Segment(Point(0, 0), Point(3, 3))).size());
+}
@@ -0,0 +1,294 @@
+#include "LogReader.hpp"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+using namespace Packet;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace {
+
+const char IndexMagic[8] = {'R', 'J', 'L', 'O', 'G', 'I', 'D', 'X'};
+const uint32_t IndexVersion = 1;
+
+/// Reads the timestamp field of a serialized LogFrame without decoding the
+/// rest of the frame
+uint64_t readTimestamp(const uint8_t* data, uint32_t size) {
+    CodedInputStream in(data, size);
+    while (uint32_t tag = in.ReadTag()) {
+        if (WireFormatLite::GetTagFieldNumber(tag) ==
+                LogFrame::kTimestampFieldNumber &&
+            WireFormatLite::GetTagWireType(tag) ==
+                WireFormatLite::WIRETYPE_VARINT) {
+            uint64_t timestamp = 0;
+            in.ReadVarint64(&timestamp);
+            return timestamp;
+        }
+        if (!WireFormatLite::SkipField(&in, tag)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+template <typename T>
+void writeValue(ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(ifstream& in, T& value) {
+    return bool(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+}  // namespace
+
+LogReader::LogReader(size_t cacheSize) : _cache(max<size_t>(cacheSize, 1)) {}
+
+LogReader::~LogReader() { close(); }
+
+bool LogReader::open(const string& filename) {
+    close();
+
+    _fd = ::open(filename.c_str(), O_RDONLY);
+    if (_fd < 0) {
+        fprintf(stderr, "Can't open %s: %s\n", filename.c_str(),
+                strerror(errno));
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(_fd, &info) != 0) {
+        fprintf(stderr, "Can't stat %s: %s\n", filename.c_str(),
+                strerror(errno));
+        close();
+        return false;
+    }
+    _fileSize = info.st_size;
+    _fileModified = int64_t(info.st_mtim.tv_sec) * 1000000000 +
+                    info.st_mtim.tv_nsec;
+
+    if (_fileSize > 0) {
+        void* data = mmap(nullptr, _fileSize, PROT_READ, MAP_SHARED, _fd, 0);
+        if (data == MAP_FAILED) {
+            fprintf(stderr, "Can't map %s: %s\n", filename.c_str(),
+                    strerror(errno));
+            close();
+            return false;
+        }
+        _data = static_cast<const uint8_t*>(data);
+    }
+    _filename = filename;
+
+    const string indexFilename = filename + ".idx";
+    if (!loadIndex(indexFilename)) {
+        buildIndex();
+        saveIndex(indexFilename);
+    }
+    buildTimeBuckets();
+
+    if (_truncated) {
+        printf("LogReader: %s ends with a partial frame\n", filename.c_str());
+    }
+
+    return true;
+}
+
+void LogReader::close() {
+    if (_data) {
+        munmap(const_cast<uint8_t*>(_data), _fileSize);
+        _data = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    _filename.clear();
+    _fileSize = 0;
+    _fileModified = 0;
+    _truncated = false;
+    _frames.clear();
+    _timeBuckets.clear();
+
+    lock_guard<mutex> lock(_cacheMutex);
+    for (CacheSlot& slot : _cache) {
+        slot.frame.reset();
+    }
+}
+
+shared_ptr<LogFrame> LogReader::frame(size_t index) const {
+    CacheSlot& slot = _cache[index % _cache.size()];
+    {
+        lock_guard<mutex> lock(_cacheMutex);
+        if (slot.frame && slot.index == index) {
+            return slot.frame;
+        }
+    }
+
+    const FrameInfo& info = _frames[index];
+    auto frame = make_shared<LogFrame>();
+
+    // Parse partial so we can recover from corrupt data
+    if (!frame->ParsePartialFromArray(_data + info.offset, info.size)) {
+        fprintf(stderr, "LogReader: Failed to parse frame %zu\n", index);
+        return nullptr;
+    }
+
+    lock_guard<mutex> lock(_cacheMutex);
+    slot.index = index;
+    slot.frame = frame;
+    return frame;
+}
+
+size_t LogReader::frameAtTime(uint64_t timestamp) const {
+    if (_frames.empty() || timestamp < _frames[0].timestamp) {
+        return 0;
+    }
+
+    const uint64_t bucket = min<uint64_t>(
+        (timestamp - _frames[0].timestamp) / _bucketWidth,
+        _timeBuckets.size() - 1);
+
+    // Find the first frame after the timestamp.  Every frame before the bucket
+    // is at or before the timestamp, so we only need to scan this bucket.
+    size_t next = _timeBuckets[bucket];
+    while (next < _frames.size() && _frames[next].timestamp <= timestamp) {
+        next++;
+    }
+    return next > 0 ? next - 1 : 0;
+}
+
+void LogReader::buildIndex() {
+    _frames.clear();
+    _truncated = false;
+
+    uint64_t offset = 0;
+    while (offset < _fileSize) {
+        uint32_t size = 0;
+        if (_fileSize - offset < sizeof(size)) {
+            _truncated = true;
+            break;
+        }
+        memcpy(&size, _data + offset, sizeof(size));
+        offset += sizeof(size);
+
+        if (_fileSize - offset < size) {
+            _truncated = true;
+            break;
+        }
+
+        _frames.push_back(
+            FrameInfo{offset, size, readTimestamp(_data + offset, size)});
+        offset += size;
+    }
+}
+
+bool LogReader::loadIndex(const string& indexFilename) {
+    ifstream in(indexFilename, ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    char magic[sizeof(IndexMagic)];
+    uint32_t version;
+    uint64_t fileSize, numFrames;
+    int64_t fileModified;
+    uint8_t truncated;
+    if (!in.read(magic, sizeof(magic)) ||
+        memcmp(magic, IndexMagic, sizeof(magic)) != 0 ||
+        !readValue(in, version) || version != IndexVersion ||
+        !readValue(in, fileSize) || fileSize != _fileSize ||
+        !readValue(in, fileModified) || fileModified != _fileModified ||
+        !readValue(in, truncated) || !readValue(in, numFrames)) {
+        return false;
+    }
+
+    // Every frame takes at least its four byte length
+    if (numFrames > _fileSize / sizeof(uint32_t)) {
+        return false;
+    }
+
+    _frames.resize(numFrames);
+    for (FrameInfo& info : _frames) {
+        if (!readValue(in, info.offset) || !readValue(in, info.size) ||
+            !readValue(in, info.timestamp) ||
+            info.offset + info.size > _fileSize) {
+            _frames.clear();
+            return false;
+        }
+    }
+    _truncated = truncated;
+
+    return true;
+}
+
+void LogReader::saveIndex(const string& indexFilename) const {
+    // Write to a temporary file first so a reader never sees a partial index
+    const string tempFilename = indexFilename + ".tmp";
+    {
+        ofstream out(tempFilename, ios::binary | ios::trunc);
+        if (!out) {
+            // The log may be in a read-only directory.  That's fine, we'll
+            // just rebuild the index next time.
+            return;
+        }
+
+        out.write(IndexMagic, sizeof(IndexMagic));
+        writeValue(out, IndexVersion);
+        writeValue(out, _fileSize);
+        writeValue(out, _fileModified);
+        writeValue(out, uint8_t(_truncated));
+        writeValue(out, uint64_t(_frames.size()));
+        for (const FrameInfo& info : _frames) {
+            writeValue(out, info.offset);
+            writeValue(out, info.size);
+            writeValue(out, info.timestamp);
+        }
+
+        if (!out) {
+            out.close();
+            unlink(tempFilename.c_str());
+            return;
+        }
+    }
+
+    rename(tempFilename.c_str(), indexFilename.c_str());
+}
+
+void LogReader::buildTimeBuckets() {
+    _timeBuckets.clear();
+    if (_frames.empty()) {
+        return;
+    }
+
+    // Use about one bucket per frame
+    const uint64_t start = _frames.front().timestamp;
+    const uint64_t span =
+        max(_frames.back().timestamp, start) - start;
+    _bucketWidth = max<uint64_t>(1, span / _frames.size());
+
+    const size_t numBuckets = span / _bucketWidth + 1;
+    _timeBuckets.resize(numBuckets);
+    size_t frame = 0;
+    for (size_t k = 0; k < numBuckets; k++) {
+        const uint64_t bucketStart = start + k * _bucketWidth;
+        while (frame < _frames.size() &&
+               _frames[frame].timestamp < bucketStart) {
+            frame++;
+        }
+        _timeBuckets[k] = frame;
+    }
+}
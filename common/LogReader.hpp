@@ -0,0 +1,118 @@
+#pragma once
+
+#include <protobuf/LogFrame.pb.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Random-access reader for log files written by Logger.
+ *
+ * @details The log file is memory-mapped and only the frame boundaries and
+ * timestamps are read when it is opened.  Frames are decoded when they are
+ * asked for, and the most recently used ones are cached.
+ *
+ * The frame index is saved next to the log in a sidecar file
+ * (<log filename>.idx) so later opens of the same log don't have to scan it.
+ * The sidecar is ignored and rebuilt if the log's size or modification time
+ * no longer match.
+ *
+ * Use Example:
+ * LogReader log;
+ * if (log.open("match.log")) {
+ *     auto frame = log.frame(log.frameAtTime(timestamp));
+ * }
+ */
+class LogReader {
+public:
+    /// @param cacheSize Number of decoded frames to keep in memory
+    explicit LogReader(size_t cacheSize = 256);
+    ~LogReader();
+
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
+    /**
+     * Opens @filename and loads or builds its frame index.  Any log that was
+     * already open is closed first.
+     *
+     * A partial frame at the end of the file (e.g. from a crash while
+     * logging) is ignored, and truncated() returns true.
+     *
+     * @return false if the file couldn't be opened or mapped
+     */
+    bool open(const std::string& filename);
+
+    void close();
+
+    bool isOpen() const { return _fd >= 0; }
+
+    const std::string& filename() const { return _filename; }
+
+    /// Number of complete frames in the log
+    size_t size() const { return _frames.size(); }
+
+    /// True if the log ended in the middle of a frame
+    bool truncated() const { return _truncated; }
+
+    /// Timestamp of frame @index, in microseconds.  Doesn't decode the frame.
+    uint64_t timestamp(size_t index) const { return _frames[index].timestamp; }
+
+    /**
+     * Decodes frame @index, which must be less than size().  Frames are
+     * parsed partially, so a corrupt frame may be missing required fields.
+     *
+     * @return the decoded frame, or nullptr if it couldn't be parsed
+     */
+    std::shared_ptr<Packet::LogFrame> frame(size_t index) const;
+
+    /**
+     * Finds the last frame with a timestamp at or before @timestamp, or frame
+     * zero if every frame is later.  This takes constant time for logs
+     * recorded at a steady rate.
+     */
+    size_t frameAtTime(uint64_t timestamp) const;
+
+private:
+    /// Location of one frame in the file
+    struct FrameInfo {
+        uint64_t offset;
+        uint32_t size;
+        uint64_t timestamp;
+    };
+
+    void buildIndex();
+    bool loadIndex(const std::string& indexFilename);
+    void saveIndex(const std::string& indexFilename) const;
+
+    /// Buckets the frames by timestamp for frameAtTime()
+    void buildTimeBuckets();
+
+    std::string _filename;
+    int _fd = -1;
+    const uint8_t* _data = nullptr;
+    uint64_t _fileSize = 0;
+    int64_t _fileModified = 0;
+    bool _truncated = false;
+
+    std::vector<FrameInfo> _frames;
+
+    /// _timeBuckets[k] is the first frame with a timestamp at or after
+    /// _frames[0].timestamp + k * _bucketWidth.  Timestamps are treated as
+    /// non-decreasing.
+    std::vector<uint32_t> _timeBuckets;
+    uint64_t _bucketWidth = 1;
+
+    /// Recently decoded frames.  Frame i can only be stored in slot
+    /// i % _cache.size(), so a run of consecutive frames (like the history
+    /// shown by the viewer) always fits.
+    struct CacheSlot {
+        size_t index;
+        std::shared_ptr<Packet::LogFrame> frame;
+    };
+    mutable std::mutex _cacheMutex;
+    mutable std::vector<CacheSlot> _cache;
+};
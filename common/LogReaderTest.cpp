@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "LogReader.hpp"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+
+using namespace std;
+using namespace Packet;
+
+namespace {
+
+/// Creates a log of @numFrames frames, 16ms apart, in the format Logger writes
+class TempLog {
+public:
+    TempLog(int numFrames, bool partialFrame = false) {
+        char name[] = "/tmp/LogReaderTestXXXXXX";
+        ::close(mkstemp(name));
+        filename = name;
+
+        ofstream out(filename, ios::binary);
+        for (int i = 0; i < numFrames; i++) {
+            LogFrame frame;
+            frame.set_timestamp(timestamp(i));
+            frame.set_manual_id(i);
+            write(out, frame.SerializeAsString());
+        }
+        if (partialFrame) {
+            LogFrame frame;
+            frame.set_timestamp(timestamp(numFrames));
+            string data = frame.SerializeAsString();
+            write(out, data.substr(0, data.size() / 2), data.size());
+        }
+    }
+
+    ~TempLog() {
+        unlink(filename.c_str());
+        unlink((filename + ".idx").c_str());
+    }
+
+    static uint64_t timestamp(int i) { return 1000000 + i * 16000; }
+
+    string filename;
+
+private:
+    static void write(ofstream& out, const string& data) {
+        write(out, data, data.size());
+    }
+
+    static void write(ofstream& out, const string& data, uint32_t size) {
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(data.data(), data.size());
+    }
+};
+
+}  // namespace
+
+TEST(LogReader, readsFrames) {
+    TempLog log(100);
+    LogReader reader(8);
+    ASSERT_TRUE(reader.open(log.filename));
+    ASSERT_EQ(100, reader.size());
+    EXPECT_FALSE(reader.truncated());
+
+    // Read out of order so the cache is exercised
+    for (int i : {5, 99, 0, 5, 13, 50, 13}) {
+        EXPECT_EQ(TempLog::timestamp(i), reader.timestamp(i));
+        shared_ptr<LogFrame> frame = reader.frame(i);
+        ASSERT_NE(nullptr, frame);
+        EXPECT_EQ(i, frame->manual_id());
+    }
+}
+
+TEST(LogReader, frameAtTime) {
+    TempLog log(1000);
+    LogReader reader;
+    ASSERT_TRUE(reader.open(log.filename));
+
+    EXPECT_EQ(0, reader.frameAtTime(0));
+    EXPECT_EQ(0, reader.frameAtTime(TempLog::timestamp(0)));
+    EXPECT_EQ(999, reader.frameAtTime(TempLog::timestamp(2000)));
+    for (int i = 0; i < 1000; i += 37) {
+        EXPECT_EQ(i, reader.frameAtTime(TempLog::timestamp(i)));
+        EXPECT_EQ(i, reader.frameAtTime(TempLog::timestamp(i) + 15999));
+    }
+}
+
+TEST(LogReader, reusesIndex) {
+    TempLog log(20, true);
+    {
+        LogReader reader;
+        ASSERT_TRUE(reader.open(log.filename));
+        EXPECT_EQ(20, reader.size());
+        EXPECT_TRUE(reader.truncated());
+    }
+    ASSERT_TRUE(ifstream(log.filename + ".idx").good());
+
+    LogReader reader;
+    ASSERT_TRUE(reader.open(log.filename));
+    EXPECT_EQ(20, reader.size());
+    EXPECT_TRUE(reader.truncated());
+    EXPECT_EQ(19, reader.frame(19)->manual_id());
+    EXPECT_EQ(7, reader.frameAtTime(TempLog::timestamp(7)));
+}
+
+TEST(LogReader, missingFile) {
+    LogReader reader;
+    EXPECT_FALSE(reader.open("/nonexistent/log"));
+    EXPECT_FALSE(reader.isOpen());
+    EXPECT_EQ(0, reader.size());
+}
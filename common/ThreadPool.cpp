@@ -0,0 +1,44 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t numThreads) {
+    numThreads = std::max<size_t>(numThreads, 1);
+    _workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _stopping = true;
+    }
+    _jobAvailable.notify_all();
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _jobAvailable.wait(lock,
+                               [this] { return _stopping || !_jobs.empty(); });
+
+            // Drain the queue before exiting so no future is left unfulfilled
+            if (_jobs.empty()) {
+                return;
+            }
+
+            job = std::move(_jobs.front());
+            _jobs.pop();
+        }
+
+        job();
+    }
+}
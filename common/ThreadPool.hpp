@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed-size pool of worker threads that run queued jobs.
+ *
+ * @details Jobs are run in the order they are enqueued by whichever worker is
+ * free first.  Each call to enqueue() returns a std::future that can be used
+ * to wait on the job and to retrieve its result (or rethrow its exception).
+ *
+ * Use Example:
+ * ThreadPool pool(4);
+ * auto result = pool.enqueue([] { return expensiveCalculation(); });
+ * doOtherWork();
+ * use(result.get());
+ */
+class ThreadPool {
+public:
+    /**
+     * Starts @numThreads worker threads.  At least one thread is always
+     * started.
+     */
+    explicit ThreadPool(size_t numThreads);
+
+    /**
+     * Finishes all jobs that have already been queued, then joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Number of worker threads in the pool
+    size_t size() const { return _workers.size(); }
+
+    /**
+     * Queues @job to be run on one of the worker threads.
+     *
+     * @return a future holding the job's return value
+     */
+    template <typename F>
+    auto enqueue(F&& job) -> std::future<decltype(job())> {
+        using Result = decltype(job());
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<F>(job));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _jobs.emplace([task]() { (*task)(); });
+        }
+        _jobAvailable.notify_one();
+        return result;
+    }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _queueMutex;
+    std::condition_variable _jobAvailable;
+    std::queue<std::function<void()>> _jobs;
+    bool _stopping = false;
+};
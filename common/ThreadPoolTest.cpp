@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <ThreadPool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+TEST(ThreadPool, runsAllJobs) {
+    ThreadPool pool(3);
+    EXPECT_EQ(3u, pool.size());
+
+    std::atomic<int> count(0);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 20; i++) {
+        results.push_back(pool.enqueue([&count, i]() {
+            count++;
+            return i * i;
+        }));
+    }
+
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(i * i, results[i].get());
+    }
+    EXPECT_EQ(20, count.load());
+}
+
+TEST(ThreadPool, propagatesExceptions) {
+    ThreadPool pool(1);
+    auto result = pool.enqueue([]() { throw std::runtime_error("failed"); });
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, atLeastOneThread) {
+    ThreadPool pool(0);
+    EXPECT_EQ(1u, pool.size());
+    EXPECT_EQ(5, pool.enqueue([]() { return 5; }).get());
+}
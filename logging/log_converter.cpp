@@ -1,6 +1,7 @@
 #include <NewRefereeModule.cpp>
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <LogReader.hpp>
 #include <protobuf/LogFrame.pb.h>
 #include <protobuf/referee.pb.h>
 
@@ -18,8 +19,6 @@ using namespace std;
 const char BAR = '|';
 const int MATCH_ID_LENGTH = 32;
 
-vector<std::shared_ptr<Packet::LogFrame> > frames;
-
 /**
  * Defines usage information for launching the Log-Viewer application
  * @param prog The name of the program
@@ -50,48 +49,6 @@ void generateMatchID(char* id, int length) {
     id[length] = '\0';
 }
 
-/**
- * Read frames and parse protobuf from specified file
- * @param filename Filename of a RoboJackets protobuf log file
- * @return true If reading and parsing was flawless
- * @return false If there was any errors or warnings while parsing
- */
-bool readFrames(const char* filename) {
-    QFile file(filename);
-
-    if (!file.open(QFile::ReadOnly)) {
-        fprintf(stderr, "Can't open %s: %s\n", filename,
-                (const char*)file.errorString().toLatin1());
-        return false;
-    }
-
-    while (!file.atEnd()) {
-        uint32_t size = 0;
-        if (file.read((char*)&size, sizeof(size)) != sizeof(size)) {
-            // Broken length
-            printf("Broken length\n");
-            return false;
-        }
-
-        string str(size, 0);
-        if (file.read(&str[0], size) != size) {
-            // Broken packet at end of file
-            printf("Broken packet\n");
-            return false;
-        }
-
-        shared_ptr<LogFrame> frame = std::make_shared<LogFrame>();
-        frames.push_back(frame);
-        // Parse partial so we can recover from corrupt data
-        if (!frame->ParsePartialFromString(str)) {
-            printf("Failed: %s\n", frame->InitializationErrorString().c_str());
-            return false;
-        }
-    }
-
-    return true;
-}
-
 int main(int argc, char* argv[]) {
     if (argc != 3) {
         usage(argv[0]);
@@ -113,8 +70,9 @@ int main(int argc, char* argv[]) {
     if (!fileFrame.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
     QTextStream outFrame(&fileFrame);
 
-    // Read in data from log file
-    if (readFrames(logFilename) == false) {
+    // Index the log file.  Frames are decoded one at a time below.
+    LogReader log(1);
+    if (!log.open(logFilename)) {
         exit(1);
     }
 
@@ -133,8 +91,12 @@ int main(int argc, char* argv[]) {
              << BAR << "yellow_score" << BAR << "blue_score" << BAR
              << "yellow_goalie" << BAR << "blue_goalie" << endl;
 
-    for (int i = 0; i < frames.size(); i++) {
-        LogFrame* currentFrame = frames[i].get();
+    for (size_t i = 0; i < log.size(); i++) {
+        shared_ptr<LogFrame> frame = log.frame(i);
+        if (!frame) {
+            continue;
+        }
+        LogFrame* currentFrame = frame.get();
 
         const long long timestamp = currentFrame->timestamp();
 
@@ -3,7 +3,6 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 
 #include <QApplication>
-#include <QFile>
 
 #include <algorithm>
 #include <fcntl.h>
@@ -62,43 +61,16 @@ LogViewer::LogViewer(QWidget* parent) : QMainWindow(parent) {
 }
 
 bool LogViewer::readFrames(const char* filename) {
-    frames.clear();
     ui.timeSlider->setMaximum(0);
 
-    QFile file(filename);
-    if (!file.open(QFile::ReadOnly)) {
-        fprintf(stderr, "Can't open %s: %s\n", filename,
-                (const char*)file.errorString().toLatin1());
+    if (!_log.open(filename) || _log.size() == 0) {
         return false;
     }
 
-    int n = 0;
-    while (!file.atEnd()) {
-        uint32_t size = 0;
-        if (file.read((char*)&size, sizeof(size)) != sizeof(size)) {
-            // Broken length
-            printf("Broken length\n");
-            return false;
-        }
-
-        string str(size, 0);
-        if (file.read(&str[0], size) != size) {
-            // Broken packet at end of file
-            printf("Broken packet\n");
-            return false;
-        }
-
-        std::shared_ptr<LogFrame> frame = std::make_shared<LogFrame>();
-        frames.push_back(frame);
-        // Parse partial so we can recover from corrupt data
-        if (!frame->ParsePartialFromString(str)) {
-            printf("Failed: %s\n", frame->InitializationErrorString().c_str());
-            return false;
-        }
-        ++n;
-    }
+    std::shared_ptr<LogFrame> first = _log.frame(0);
+    _firstCommandTime = first ? first->command_time() : 0;
 
-    ui.timeSlider->setMaximum(frames.size());
+    ui.timeSlider->setMaximum(_log.size());
     return true;
 }
 
@@ -111,19 +83,27 @@ void LogViewer::updateViews() {
     }
     _lastUpdateTime = time;
 
+    if (_log.size() == 0) {
+        return;
+    }
+
     // Limit to available data
     _doubleFrameNumber = max(0.0, _doubleFrameNumber);
-    _doubleFrameNumber = min(frames.size() - 1.0, _doubleFrameNumber);
+    _doubleFrameNumber = min(_log.size() - 1.0, _doubleFrameNumber);
 
     int f = frameNumber();
-    const LogFrame& currentFrame = *frames[f];
+    std::shared_ptr<LogFrame> frame = _log.frame(f);
+    if (!frame) {
+        return;
+    }
+    const LogFrame& currentFrame = *frame;
 
     ui.timeSlider->setValue(f);
 
     // Copy recent history into the FieldView
     int n = min(f, (int)_history.size());
     for (int i = 0; i < n; ++i) {
-        _history[i] = frames[f - i];
+        _history[i] = _log.frame(f - i);
     }
     for (int i = n; i < (int)_history.size(); ++i) {
         _history[i].reset();
@@ -133,7 +113,7 @@ void LogViewer::updateViews() {
     _frameNumberItem->setData(ProtobufTree::Column_Value, Qt::DisplayRole,
                               frameNumber());
     int elapsedMillis =
-        (currentFrame.command_time() - frames[0]->command_time() + 500) / 1000;
+        (currentFrame.command_time() - _firstCommandTime + 500) / 1000;
     QTime elapsedTime = QTime::fromMSecsSinceStartOfDay(elapsedMillis);
     _elapsedTimeItem->setText(ProtobufTree::Column_Value,
                               elapsedTime.toString("hh:mm:ss.zzz"));
@@ -191,4 +171,4 @@ void LogViewer::on_logPrev_clicked() {
 
 void LogViewer::on_logBeginning_clicked() { frameNumber(0); }
 
-void LogViewer::on_logEnd_clicked() { frameNumber(frames.size() - 1); }
+void LogViewer::on_logEnd_clicked() { frameNumber(_log.size() - 1); }
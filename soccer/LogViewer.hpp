@@ -2,6 +2,7 @@
 
 #include <ui_LogViewer.h>
 #include <protobuf/LogFrame.pb.h>
+#include <LogReader.hpp>
 
 #include <QTime>
 #include <QTimer>
@@ -17,11 +18,9 @@ public:
 
     void frameNumber(int value) { _doubleFrameNumber = value; }
 
-    // This is called when
+    // Opens a log file.  Frames are decoded from it as they are displayed.
     bool readFrames(const char* filename);
 
-    std::vector<std::shared_ptr<Packet::LogFrame> > frames;
-
 public Q_SLOTS:
     void updateViews();
 
@@ -50,6 +49,11 @@ private:
     QTime _lastUpdateTime;
     double _doubleFrameNumber;
 
+    LogReader _log;
+
+    // command_time of the first frame in the log
+    int64_t _firstCommandTime = 0;
+
     // Recent history.
     // Yeah, it's copied, but if it works in soccer then it works here.
     std::vector<std::shared_ptr<Packet::LogFrame> > _history;
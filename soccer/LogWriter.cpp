@@ -0,0 +1,201 @@
+#include "LogWriter.hpp"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Packet;
+
+namespace {
+
+// The pending buffer is written out once it reaches this size...
+constexpr size_t FlushSize = 256 * 1024;
+
+// ...or when the oldest frame in it has waited this long
+constexpr chrono::milliseconds FlushInterval(100);
+
+// How long the writer sleeps between checks of the queue
+constexpr chrono::milliseconds PollInterval(20);
+
+}  // namespace
+
+LogWriter::LogWriter(size_t queueSize, OverflowPolicy policy)
+    : _queue(queueSize), _policy(policy) {
+    _pending.reserve(FlushSize * 2);
+}
+
+LogWriter::~LogWriter() { close(); }
+
+void LogWriter::open(int fd) {
+    close();
+
+    _fd = fd;
+    _stopping = false;
+    _open = true;
+    _rateWindowStart = chrono::steady_clock::now();
+    _rateWindowBytes = 0;
+    _thread = thread(&LogWriter::run, this);
+}
+
+void LogWriter::close() {
+    if (!_thread.joinable()) {
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(_wakeMutex);
+        _stopping = true;
+    }
+    _frameQueued.notify_one();
+    _thread.join();
+
+    // Anything left in the queue was submitted after a write failure
+    _queue.reset();
+
+    ::close(_fd);
+    _fd = -1;
+    _open = false;
+    _failed = false;
+    _bytesPerSecond = 0;
+}
+
+bool LogWriter::submit(shared_ptr<const LogFrame> frame) {
+    if (!_open) {
+        return false;
+    }
+
+    if (_queue.push(move(frame))) {
+        return true;
+    }
+
+    if (_policy == OverflowPolicy::Block) {
+        unique_lock<mutex> lock(_wakeMutex);
+        while (_open) {
+            if (_queue.push(frame)) {
+                _submitWaiting = false;
+                return true;
+            }
+
+            // Wake the writer instead of waiting for its next poll
+            _submitWaiting = true;
+            _frameQueued.notify_one();
+            _roomAvailable.wait_for(lock, PollInterval);
+        }
+        _submitWaiting = false;
+    }
+
+    _droppedFrames++;
+    return false;
+}
+
+LogWriter::Stats LogWriter::stats() const {
+    Stats stats;
+    stats.queueDepth = _queue.read_available();
+    stats.droppedFrames = _droppedFrames;
+    stats.framesWritten = _framesWritten;
+    stats.bytesWritten = _bytesWritten;
+    stats.bytesPerSecond = _bytesPerSecond;
+    return stats;
+}
+
+void LogWriter::run() {
+    auto oldestPending = chrono::steady_clock::now();
+    while (true) {
+        // Read this before draining the queue so that frames submitted just
+        // before close() are still written
+        const bool stopping = _stopping;
+
+        shared_ptr<const LogFrame> frame;
+        bool popped = false;
+        while (_queue.pop(frame)) {
+            if (_pending.empty()) {
+                oldestPending = chrono::steady_clock::now();
+            }
+            serialize(*frame);
+            frame.reset();
+            popped = true;
+
+            if (_pending.size() >= FlushSize && !flush()) {
+                return;
+            }
+        }
+        if (popped) {
+            // Synchronize with a blocked submit() so the wakeup isn't lost
+            { lock_guard<mutex> lock(_wakeMutex); }
+            _roomAvailable.notify_all();
+        }
+
+        if (!_pending.empty() &&
+            (stopping ||
+             chrono::steady_clock::now() - oldestPending >= FlushInterval)) {
+            if (!flush()) {
+                return;
+            }
+        }
+        updateRate();
+
+        if (stopping) {
+            return;
+        }
+
+        unique_lock<mutex> lock(_wakeMutex);
+        _frameQueued.wait_for(lock, PollInterval,
+                              [this] { return _stopping || _submitWaiting; });
+    }
+}
+
+void LogWriter::serialize(const LogFrame& frame) {
+    if (!frame.IsInitialized()) {
+        printf("LogWriter: Not writing frame missing fields: %s\n",
+               frame.InitializationErrorString().c_str());
+        return;
+    }
+
+    const uint32_t size = frame.ByteSize();
+    const size_t start = _pending.size();
+    _pending.resize(start + sizeof(size) + size);
+
+    uint8_t* out = reinterpret_cast<uint8_t*>(&_pending[start]);
+    memcpy(out, &size, sizeof(size));
+    frame.SerializeWithCachedSizesToArray(out + sizeof(size));
+
+    _framesWritten++;
+}
+
+bool LogWriter::flush() {
+    const char* data = _pending.data();
+    size_t remaining = _pending.size();
+    while (remaining > 0) {
+        ssize_t n = write(_fd, data, remaining);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("LogWriter: Failed to write frames, closing log: %m\n");
+            _failed = true;
+            _open = false;
+            _pending.clear();
+            _roomAvailable.notify_all();
+            return false;
+        }
+        data += n;
+        remaining -= n;
+    }
+
+    _bytesWritten += _pending.size();
+    _rateWindowBytes += _pending.size();
+    _pending.clear();
+    return true;
+}
+
+void LogWriter::updateRate() {
+    const auto now = chrono::steady_clock::now();
+    const chrono::duration<double> elapsed = now - _rateWindowStart;
+    if (elapsed >= chrono::seconds(1)) {
+        _bytesPerSecond = _rateWindowBytes / elapsed.count();
+        _rateWindowStart = now;
+        _rateWindowBytes = 0;
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <protobuf/LogFrame.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+/**
+ * @brief Writes LogFrames to a file descriptor on a background thread.
+ *
+ * @details Frames are handed to the writer thread through a bounded lock-free
+ * queue, so submit() never makes a syscall.  The writer serializes frames into
+ * a buffer and writes them out in large batches.
+ *
+ * The file format is the same as always: each frame is written as its
+ * serialized size (a native-endian uint32_t) followed by the serialized frame.
+ *
+ * submit() must only be called from one thread at a time.  Frames must not be
+ * modified after they are submitted.
+ */
+class LogWriter {
+public:
+    /// What to do with a frame that is submitted while the queue is full
+    enum class OverflowPolicy {
+        /// Throw the new frame away.  Never blocks the caller.
+        DropNewest,
+
+        /// Wait for the writer thread to make room.  No frames are lost, but
+        /// a slow disk will stall the caller.
+        Block
+    };
+
+    struct Stats {
+        /// Frames waiting to be written
+        size_t queueDepth = 0;
+
+        /// Frames thrown away because the queue was full
+        uint64_t droppedFrames = 0;
+
+        uint64_t framesWritten = 0;
+        uint64_t bytesWritten = 0;
+
+        /// Write rate over the last second or so
+        double bytesPerSecond = 0;
+    };
+
+    explicit LogWriter(size_t queueSize = 1024,
+                       OverflowPolicy policy = OverflowPolicy::DropNewest);
+
+    /// Flushes any queued frames and closes the file
+    ~LogWriter();
+
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    /**
+     * Starts writing to @fd, which the writer takes ownership of.  Any file
+     * that was already open is flushed and closed first.
+     */
+    void open(int fd);
+
+    /// Writes all queued frames, then closes the file
+    void close();
+
+    /// True while a file is open and no write has failed
+    bool isOpen() const { return _open; }
+
+    /// True if a write to the open file failed and stopped the writer.  The
+    /// file stays open until close().
+    bool failed() const { return _failed; }
+
+    /**
+     * Queues @frame to be written.
+     *
+     * @return false if the frame was dropped, either because no file is open
+     *     or because the queue is full
+     */
+    bool submit(std::shared_ptr<const Packet::LogFrame> frame);
+
+    void setOverflowPolicy(OverflowPolicy policy) { _policy = policy; }
+    OverflowPolicy overflowPolicy() const { return _policy; }
+
+    Stats stats() const;
+
+private:
+    void run();
+
+    /// Appends @frame to the pending buffer in the log file format
+    void serialize(const Packet::LogFrame& frame);
+
+    /// Writes out the pending buffer.  Returns false if the write failed.
+    bool flush();
+
+    void updateRate();
+
+    boost::lockfree::spsc_queue<std::shared_ptr<const Packet::LogFrame>>
+        _queue;
+    std::atomic<OverflowPolicy> _policy;
+
+    /// Wakes the writer thread when frames are queued, and wakes a blocked
+    /// submit() when the writer has made room
+    std::mutex _wakeMutex;
+    std::condition_variable _frameQueued;
+    std::condition_variable _roomAvailable;
+
+    std::thread _thread;
+    std::atomic<bool> _open{false};
+    std::atomic<bool> _failed{false};
+    std::atomic<bool> _stopping{false};
+
+    /// Set while submit() is blocked on a full queue.  Guarded by _wakeMutex.
+    bool _submitWaiting = false;
+    int _fd = -1;
+
+    /// Serialized frames waiting to be written.  Only used by the writer.
+    std::string _pending;
+
+    std::atomic<uint64_t> _droppedFrames{0};
+    std::atomic<uint64_t> _framesWritten{0};
+    std::atomic<uint64_t> _bytesWritten{0};
+    std::atomic<double> _bytesPerSecond{0};
+
+    /// Start of the current rate measurement window.  Only used by the writer.
+    std::chrono::steady_clock::time_point _rateWindowStart;
+    uint64_t _rateWindowBytes = 0;
+};
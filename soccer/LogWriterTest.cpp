@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "LogWriter.hpp"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace Packet;
+
+namespace {
+
+shared_ptr<LogFrame> makeFrame(uint64_t timestamp) {
+    auto frame = make_shared<LogFrame>();
+    frame->set_timestamp(timestamp);
+    frame->add_debug_layers("layer " + to_string(timestamp));
+    return frame;
+}
+
+/// Reads back a log file in the length-prefixed format
+vector<LogFrame> readLog(const string& filename) {
+    ifstream file(filename, ios::binary);
+    vector<LogFrame> frames;
+    uint32_t size;
+    while (file.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+        string data(size, 0);
+        EXPECT_TRUE(file.read(&data[0], size));
+        frames.emplace_back();
+        EXPECT_TRUE(frames.back().ParseFromString(data));
+    }
+    return frames;
+}
+
+class TempFile {
+public:
+    TempFile() {
+        char name[] = "/tmp/LogWriterTestXXXXXX";
+        _fd = mkstemp(name);
+        _name = name;
+    }
+    ~TempFile() { unlink(_name.c_str()); }
+
+    int fd() const { return _fd; }
+    const string& name() const { return _name; }
+
+private:
+    int _fd;
+    string _name;
+};
+
+}  // namespace
+
+TEST(LogWriter, writesAllFramesInOrder) {
+    TempFile file;
+    LogWriter writer(16, LogWriter::OverflowPolicy::Block);
+    writer.open(file.fd());
+    EXPECT_TRUE(writer.isOpen());
+
+    for (int i = 0; i < 500; i++) {
+        EXPECT_TRUE(writer.submit(makeFrame(i)));
+    }
+    writer.close();
+    EXPECT_FALSE(writer.isOpen());
+
+    vector<LogFrame> frames = readLog(file.name());
+    ASSERT_EQ(500, frames.size());
+    for (int i = 0; i < 500; i++) {
+        EXPECT_EQ(i, frames[i].timestamp());
+    }
+
+    LogWriter::Stats stats = writer.stats();
+    EXPECT_EQ(500, stats.framesWritten);
+    EXPECT_EQ(0, stats.droppedFrames);
+    EXPECT_EQ(0, stats.queueDepth);
+}
+
+TEST(LogWriter, skipsIncompleteFrames) {
+    TempFile file;
+    LogWriter writer;
+    writer.open(file.fd());
+    writer.submit(makeFrame(1));
+    writer.submit(make_shared<LogFrame>());  // Missing timestamp
+    writer.submit(makeFrame(2));
+    writer.close();
+
+    vector<LogFrame> frames = readLog(file.name());
+    ASSERT_EQ(2, frames.size());
+    EXPECT_EQ(2, frames[1].timestamp());
+}
+
+TEST(LogWriter, dropsWhenFull) {
+    TempFile file;
+    LogWriter writer(4, LogWriter::OverflowPolicy::DropNewest);
+    writer.open(file.fd());
+
+    // Submit much faster than the writer thread wakes up
+    int accepted = 0;
+    for (int i = 0; i < 100; i++) {
+        accepted += writer.submit(makeFrame(i));
+    }
+    writer.close();
+
+    LogWriter::Stats stats = writer.stats();
+    EXPECT_EQ(100, accepted + stats.droppedFrames);
+    EXPECT_EQ(accepted, stats.framesWritten);
+    EXPECT_EQ(accepted, readLog(file.name()).size());
+}
+
+TEST(LogWriter, notOpen) {
+    LogWriter writer;
+    EXPECT_FALSE(writer.submit(makeFrame(1)));
+    writer.close();
+}
+
+TEST(LogWriter, writeFailure) {
+    // Every write to /dev/full fails
+    const int fd = open("/dev/full", O_WRONLY);
+    ASSERT_GE(fd, 0);
+    LogWriter writer;
+    writer.open(fd);
+    EXPECT_FALSE(writer.failed());
+
+    // The writer stops at the first flush
+    for (int i = 0; i < 100 && writer.isOpen(); i++) {
+        writer.submit(makeFrame(i));
+        usleep(10 * 1000);
+    }
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_TRUE(writer.failed());
+    EXPECT_FALSE(writer.submit(makeFrame(100)));
+
+    writer.close();
+    EXPECT_FALSE(writer.failed());
+}
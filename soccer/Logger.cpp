@@ -5,43 +5,39 @@
 #include <stdio.h>
 #include <unistd.h>
 #include "Utils.hpp"
+#include <LogReader.hpp>
 
 using namespace std;
 using namespace Packet;
 using namespace google::protobuf::io;
 
 Logger::Logger(size_t logSize) : _history(logSize) {
-    _fd = -1;
     _spaceUsed = sizeof(shared_ptr<Packet::LogFrame>) * _history.size();
 }
 
 Logger::~Logger() { close(); }
 
 bool Logger::open(QString filename) {
-    QWriteLocker locker(&_lock);
-
-    if (_fd >= 0) {
-        close();
-    }
+    close();
 
-    _fd = creat(filename.toLatin1(), 0666);
-    if (_fd < 0) {
+    int fd = creat(filename.toLatin1(), 0666);
+    if (fd < 0) {
         printf("Can't create %s: %m\n", (const char*)filename.toLatin1());
         return false;
     }
 
+    QWriteLocker locker(&_lock);
+    _writer.open(fd);
     _filename = filename;
 
     return true;
 }
 
 void Logger::close() {
+    // Waits for queued frames to be written
     QWriteLocker locker(&_lock);
-    if (_fd >= 0) {
-        ::close(_fd);
-        _fd = -1;
-        _filename = QString();
-    }
+    _writer.close();
+    _filename = QString();
 }
 
 void Logger::addFrame(shared_ptr<LogFrame> frame) {
@@ -55,21 +51,13 @@ void Logger::addFrame(shared_ptr<LogFrame> frame, bool force) {
         _startTime = RJ::Time(chrono::microseconds(frame->timestamp()));
     }
 
-    // Write this from to the file
-    if (_fd >= 0) {
-        if (frame->IsInitialized()) {
-            uint32_t size = frame->ByteSize();
-            if (write(_fd, &size, sizeof(size)) != sizeof(size)) {
-                printf("Logger: Failed to write size, closing log: %m\n");
-                close();
-            } else if (!frame->SerializeToFileDescriptor(_fd)) {
-                printf("Logger: Failed to write frame, closing log: %m\n");
-                close();
-            }
-        } else {
-            printf("Logger: Not writing frame missing fields: %s\n",
-                   frame->InitializationErrorString().c_str());
-        }
+    // Queue this frame to be written to the file
+    if (_writer.isOpen()) {
+        _writer.submit(frame);
+    } else if (_writer.failed()) {
+        // Writing stopped, so close the file and stop reporting it
+        _writer.close();
+        _filename = QString();
     }
 
     if (_history.full() && !force) {
@@ -100,36 +88,25 @@ void Logger::clear() {
 bool Logger::readFrames(const char* filename) {
     this->clear();
 
-    QFile file(filename);
-    if (!file.open(QFile::ReadOnly)) {
-        fprintf(stderr, "Can't open %s: %s\n", filename,
-                (const char*)file.errorString().toLatin1());
+    LogReader log;
+    if (!log.open(filename)) {
         return false;
     }
 
-    int n = 0;
-    while (!file.atEnd()) {
-        uint32_t size = 0;
-        if (file.read((char*)&size, sizeof(size)) != sizeof(size)) {
-            // Broken length
-            printf("Broken length\n");
-            return false;
-        }
-
-        string str(size, 0);
-        if (file.read(&str[0], size) != size) {
-            // Broken packet at end of file
-            printf("Broken packet\n");
-            return false;
-        }
-
-        std::shared_ptr<LogFrame> frame = std::make_shared<LogFrame>();
-        if (!frame->ParsePartialFromString(str)) {
-            printf("Failed: %s\n", frame->InitializationErrorString().c_str());
+    // Only the frames that fit in the history are decoded
+    const size_t first = log.size() > capacity() ? log.size() - capacity() : 0;
+    for (size_t i = first; i < log.size(); i++) {
+        std::shared_ptr<LogFrame> frame = log.frame(i);
+        if (!frame) {
             return false;
         }
         this->addFrame(frame, true);
-        ++n;
+    }
+
+    if (log.size() > 0) {
+        QWriteLocker locker(&_lock);
+        _startTime = RJ::Time(chrono::microseconds(log.timestamp(0)));
+        _nextFrameNumber = log.size();
     }
 
     return true;
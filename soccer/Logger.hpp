@@ -8,7 +8,8 @@
  * full list of what is stored in the log.
  *
  * This logger implements a circular buffer for recent history and writes all
- * frames to disk.
+ * frames to disk.  Disk writes happen on a background thread (see LogWriter),
+ * so a slow disk can't stall the caller of addFrame().
  *
  * _history is a circular buffer.
  *
@@ -42,6 +43,7 @@
 #include <algorithm>
 #include <memory>
 #include "time.hpp"
+#include "LogWriter.hpp"
 #include <boost/circular_buffer.hpp>
 
 class Logger {
@@ -77,9 +79,22 @@ public:
     // Returns the amount of memory used by all LogFrames in the history.
     int spaceUsed() const { return _spaceUsed; }
 
-    bool recording() const { return _fd >= 0; }
+    bool recording() const { return _writer.isOpen(); }
 
-    QString filename() const { return _filename; }
+    // Counters for the frames being written to disk
+    LogWriter::Stats writerStats() const { return _writer.stats(); }
+
+    // Chooses whether addFrame() drops frames or waits when the disk can't
+    // keep up
+    void setOverflowPolicy(LogWriter::OverflowPolicy policy) {
+        _writer.setOverflowPolicy(policy);
+    }
+
+    // The file being written, or an empty string if there isn't one or
+    // writing to it failed
+    QString filename() const {
+        return _writer.isOpen() ? _filename : QString();
+    }
 
     int firstFrameNumber() const {
         return currentFrameNumber() - _history.size() + 1;
@@ -125,8 +140,8 @@ private:
 
     int _spaceUsed;
 
-    // File descriptor for log file
-    int _fd;
+    // Writes frames to the log file
+    LogWriter _writer;
 
     // Sequence number of the next frame to be written
     int _nextFrameNumber = 0;
@@ -65,6 +65,8 @@ MainWindow::MainWindow(Processor* processor, QWidget* parent)
     _ui.logTree->mainWindow = this;
     _ui.logTree->updateTimer = &updateTimer;
 
+    _ui.stageTiming->history(&_longHistory);
+
     // Initialize live/non-live control styles
 
     _currentPlay = new QLabel(this);
@@ -362,12 +364,21 @@ void MainWindow::updateViews() {
         _procFPS->setText(
             QString("Proc: %1 fps").arg(_processor->framerate(), 0, 'f', 1));
 
-        _logMemory->setText(
+        QString logText =
             QString("Log: %1/%2 %3 kiB")
                 .arg(QString::number(_processor->logger().size()),
                      QString::number(_processor->logger().capacity()),
                      QString::number((_processor->logger().spaceUsed() + 512) /
-                                     1024)));
+                                     1024));
+        if (_processor->logger().recording()) {
+            LogWriter::Stats stats = _processor->logger().writerStats();
+            logText += QString(", disk %1 kiB/s, %2 queued, %3 dropped")
+                           .arg(QString::number(
+                                    (int)(stats.bytesPerSecond / 1024)),
+                                QString::number(stats.queueDepth),
+                                QString::number(stats.droppedFrames));
+        }
+        _logMemory->setText(logText);
     }
 
     auto value = _ui.logHistoryLocation->value();
@@ -409,6 +420,7 @@ void MainWindow::updateViews() {
 
     // Update field view
     _ui.fieldView->update();
+    _ui.stageTiming->update();
 
     // enable playback buttons based on playback rate
     for (QPushButton* playbackBtn : _logPlaybackButtons)
@@ -23,6 +23,7 @@
 #include <planning/IndependentMultiRobotPathPlanner.hpp>
 #include <rc-fshare/git_version.hpp>
 #include "Processor.hpp"
+#include "StageTimer.hpp"
 #include "vision/VisionFilter.hpp"
 #include "radio/SimRadio.hpp"
 #include "radio/USBRadio.hpp"
@@ -41,6 +42,9 @@ RobotConfig* Processor::robotConfig2011;
 RobotConfig* Processor::robotConfig2015;
 std::vector<RobotStatus*>
     Processor::robotStatuses;  ///< FIXME: verify that this is correct
+ConfigBool* Processor::_eventDrivenLoop;
+ConfigDouble* Processor::_minFramePeriod;
+ConfigDouble* Processor::_maxFramePeriod;
 
 Field_Dimensions* currentDimensions = &Field_Dimensions::Current_Dimensions;
 
@@ -53,6 +57,18 @@ void Processor::createConfiguration(Configuration* cfg) {
         robotStatuses.push_back(
             new RobotStatus(cfg, QString("Robot Statuses/Robot %1").arg(s)));
     }
+
+    _eventDrivenLoop = new ConfigBool(
+        cfg, "Processor/Timing/eventDriven", false,
+        "Start each iteration of the processing loop when new vision data "
+        "arrives instead of at a fixed rate");
+    _minFramePeriod = new ConfigDouble(
+        cfg, "Processor/Timing/minPeriod", 1000.0 / 120,
+        "Minimum time between event-driven iterations, in milliseconds");
+    _maxFramePeriod = new ConfigDouble(
+        cfg, "Processor/Timing/maxPeriod", 1000.0 / 50,
+        "Maximum time between event-driven iterations when no vision data "
+        "arrives, in milliseconds");
 }
 
 Processor::Processor(bool sim, bool defendPlus, VisionChannel visionChannel,
@@ -286,6 +302,13 @@ void Processor::run() {
             logConfig->set_simulation(_simulation);
         }
 
+        // Adding the last frame to the log happened after it was finished
+        if (_lastLogWriteTime) {
+            StageTimer::record(*_state.logFrame, Packet::StageTiming::LogWrite,
+                               *_lastLogWriteTime);
+            _lastLogWriteTime.reset();
+        }
+
         for (OurRobot* robot : _state.self) {
             // overall robot config
             switch (robot->hardwareVersion()) {
@@ -312,6 +335,9 @@ void Processor::run() {
         // Inputs
 
         // Read vision packets
+        StageTimer visionTimer(*_state.logFrame,
+                               Packet::StageTiming::VisionIntake);
+        std::optional<double> newestCaptureTime;
         vector<const SSL_DetectionFrame*> detectionFrames;
         vector<VisionPacket*> visionPackets;
         vision.getPackets(visionPackets);
@@ -334,6 +360,8 @@ void Processor::run() {
                     RJ::numSeconds(packet->receivedTime.time_since_epoch());
                 det->set_t_capture(rt - det->t_sent() + det->t_capture());
                 det->set_t_sent(rt);
+                newestCaptureTime =
+                    std::max(newestCaptureTime.value_or(0), det->t_capture());
 
                 // Remove balls on the excluded half of the field
                 google::protobuf::RepeatedPtrField<SSL_DetectionBall>* balls =
@@ -379,7 +407,11 @@ void Processor::run() {
             }
         }
 
+        visionTimer.stop();
+
         // Read radio reverse packets
+        StageTimer radioTimer(*_state.logFrame,
+                              Packet::StageTiming::RadioReceive);
         _radio->receive();
 
         while (_radio->hasReversePackets()) {
@@ -400,17 +432,24 @@ void Processor::run() {
             }
         }
 
+        radioTimer.stop();
+
         for (Joystick* joystick : _joysticks) {
             joystick->update();
         }
         GamepadController::joystickRemoved = -1;
 
-        runModels(detectionFrames);
-        for (VisionPacket* packet : visionPackets) {
-            delete packet;
+        {
+            StageTimer timer(*_state.logFrame, Packet::StageTiming::RunModels);
+            runModels(detectionFrames);
+
+            // detectionFrames points into the packets, so they can only be
+            // handed back now
+            vision.releasePackets();
         }
 
         // Log referee data
+        StageTimer refereeTimer(*_state.logFrame, Packet::StageTiming::Referee);
         vector<NewRefereePacket*> refereePackets;
         _refereeModule.get()->getPackets(refereePackets);
         for (NewRefereePacket* packet : refereePackets) {
@@ -437,9 +476,16 @@ void Processor::run() {
 
         _state.logFrame->set_team_name_blue(bluename);
         _state.logFrame->set_team_name_yellow(yellowname);
+        refereeTimer.stop();
 
         // Run high-level soccer logic
-        _gameplayModule->run();
+        {
+            StageTimer timer(*_state.logFrame, Packet::StageTiming::Gameplay);
+            _gameplayModule->run();
+        }
+
+        StageTimer obstaclesTimer(*_state.logFrame,
+                                  Packet::StageTiming::Obstacles);
 
         // recalculates Field obstacles on every run through to account for
         // changing inset
@@ -495,7 +541,11 @@ void Processor::run() {
             }
         }
 
+        obstaclesTimer.stop();
+
         // Run path planner and set the path for each robot that was planned for
+        StageTimer planningTimer(*_state.logFrame,
+                                 Packet::StageTiming::PathPlanning);
         auto pathsById = _pathPlanner->run(std::move(requests));
         for (auto& entry : pathsById) {
             OurRobot* r = _state.self[entry.first];
@@ -508,12 +558,16 @@ void Processor::run() {
                 angleFunctionForCommandType(r->rotationCommand());
         }
 
+        planningTimer.stop();
+
         // Visualize obstacles
         for (auto& shape : globalObstacles.shapes()) {
             _state.drawShape(shape, Qt::black, "Global Obstacles");
         }
 
         // Run velocity controllers
+        StageTimer motionTimer(*_state.logFrame,
+                               Packet::StageTiming::MotionControl);
         for (OurRobot* robot : _state.self) {
             if (robot->visible) {
                 if ((_manualID >= 0 && (int)robot->shell() == _manualID) ||
@@ -525,8 +579,12 @@ void Processor::run() {
             }
         }
 
+        motionTimer.stop();
+
         ////////////////
         // Store logging information
+        StageTimer assemblyTimer(*_state.logFrame,
+                                 Packet::StageTiming::LogFrameAssembly);
 
         // Debug layers
         const QStringList& layers = _state.debugLayers();
@@ -601,15 +659,29 @@ void Processor::run() {
             *log->mutable_vel() = _state.ball.vel;
         }
 
+        assemblyTimer.stop();
+
         ////////////////
         // Outputs
 
         // Send motion commands to the robots
-        sendRadioData();
+        {
+            StageTimer timer(*_state.logFrame, Packet::StageTiming::RadioSend);
+            sendRadioData();
+        }
+
+        if (newestCaptureTime) {
+            const double sentTime =
+                RJ::numSeconds(RJ::now().time_since_epoch());
+            _state.logFrame->set_capture_to_radio_latency(
+                (sentTime - *newestCaptureTime) * 1000000);
+        }
 
         // Write to the log unless we are viewing logs
         if (_readLogFile.empty()) {
+            const RJ::Time logStart = RJ::now();
             _logger.addFrame(_state.logFrame);
+            _lastLogWriteTime = RJ::now() - logStart;
         }
 
         // Store processing loop status
@@ -625,7 +697,17 @@ void Processor::run() {
 
         auto endTime = RJ::now();
         auto timeLapse = endTime - startTime;
-        if (timeLapse < _framePeriod) {
+        if (*_eventDrivenLoop) {
+            const RJ::Seconds minPeriod(_minFramePeriod->value() / 1000);
+            const RJ::Seconds maxPeriod(
+                std::max(_maxFramePeriod->value(), _minFramePeriod->value()) /
+                1000);
+
+            if (timeLapse < minPeriod) {
+                ::usleep(RJ::numMicroseconds(minPeriod - timeLapse));
+            }
+            vision.waitForPackets(startTime + maxPeriod);
+        } else if (timeLapse < _framePeriod) {
             // Use system usleep, not QThread::usleep.
             //
             // QThread::usleep uses pthread_cond_wait which sometimes fails to
@@ -217,6 +217,13 @@ private:
     // per-robot status configs
     static std::vector<RobotStatus*> robotStatuses;
 
+    // Loop scheduling.  When event-driven, each iteration starts as soon as new
+    // vision data arrives, but never sooner than the minimum period after the
+    // previous one started or later than the maximum period.
+    static ConfigBool* _eventDrivenLoop;
+    static ConfigDouble* _minFramePeriod;
+    static ConfigDouble* _maxFramePeriod;
+
     /** send out the radio data for the radio program */
     void sendRadioData();
 
@@ -268,12 +275,16 @@ private:
 
     bool _defendPlusX;
 
-    // Processing period in microseconds
+    // Processing period when the loop isn't event-driven
     RJ::Seconds _framePeriod = RJ::Seconds(1) / 60;
 
     /// Measured framerate
     float _framerate;
 
+    /// How long it took to add the previous LogFrame to the logger.  This is
+    /// recorded in the next frame, since a logged frame can't be changed.
+    std::optional<RJ::Seconds> _lastLogWriteTime;
+
     // This is used by the GUI to indicate status of the processing loop and
     // network
     QMutex _statusMutex;
@@ -60,7 +60,9 @@ public:
         : visible(false),
           velValid(false),
           angle(0),
-          angleVel(0) {
+          angleVel(0),
+          posCov(0),
+          velCov(0) {
         // normalize angle so it's always positive
         // while (angle < 0) angle += 2.0 * M_PI;
     }
@@ -73,6 +75,9 @@ public:
     /// angle in radians.  0 radians means the robot is aimed along the x-axis
     double angle;
     double angleVel;  /// angular velocity in radians/sec
+    /// average position and velocity covariance of the vision filter
+    double posCov;
+    double velCov;
     RJ::Time time;
 };
 
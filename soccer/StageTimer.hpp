@@ -0,0 +1,50 @@
+#pragma once
+
+#include <protobuf/LogFrame.pb.h>
+#include "time.hpp"
+
+/**
+ * @brief Records how long a stage of the processing loop takes.
+ *
+ * @details The time from construction until stop() (or destruction, whichever
+ * comes first) is added to the LogFrame as a StageTiming.
+ *
+ * Use Example:
+ * {
+ *     StageTimer timer(*_state.logFrame, Packet::StageTiming::Gameplay);
+ *     _gameplayModule->run();
+ * }
+ */
+class StageTimer {
+public:
+    StageTimer(Packet::LogFrame& frame, Packet::StageTiming::Stage stage)
+        : _frame(frame), _stage(stage), _start(RJ::now()) {}
+
+    ~StageTimer() { stop(); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    /// Records the elapsed time.  Does nothing if already stopped.
+    void stop() {
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+        record(_frame, _stage, RJ::now() - _start);
+    }
+
+    /// Records a stage that was timed some other way
+    static void record(Packet::LogFrame& frame,
+                       Packet::StageTiming::Stage stage, RJ::Seconds time) {
+        Packet::StageTiming* timing = frame.add_stage_timing();
+        timing->set_stage(stage);
+        timing->set_time(RJ::numMicroseconds(time));
+    }
+
+private:
+    Packet::LogFrame& _frame;
+    Packet::StageTiming::Stage _stage;
+    RJ::Time _start;
+    bool _stopped = false;
+};
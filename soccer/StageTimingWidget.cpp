@@ -0,0 +1,136 @@
+#include "StageTimingWidget.hpp"
+
+#include <QPainter>
+
+#include <algorithm>
+#include <protobuf/LogFrame.pb.h>
+
+using namespace std;
+using namespace Packet;
+
+namespace {
+
+/// Summary of the times for one stage, in milliseconds
+struct Percentiles {
+    float p50 = 0, p90 = 0, p99 = 0, max = 0;
+};
+
+Percentiles percentiles(vector<float>& times) {
+    Percentiles result;
+    if (times.empty()) {
+        return result;
+    }
+
+    sort(times.begin(), times.end());
+    auto at = [&](float fraction) {
+        return times[min<size_t>(times.size() * fraction, times.size() - 1)];
+    };
+    result.p50 = at(0.5);
+    result.p90 = at(0.9);
+    result.p99 = at(0.99);
+    result.max = times.back();
+    return result;
+}
+
+}  // namespace
+
+StageTimingWidget::StageTimingWidget(QWidget* parent) : QWidget(parent) {
+    QPalette p = palette();
+    p.setColor(QPalette::Window, Qt::black);
+    setPalette(p);
+    setAutoFillBackground(true);
+
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    setMinimumSize(200, 100);
+}
+
+void StageTimingWidget::paintEvent(QPaintEvent* e) {
+    if (!_history || _history->empty()) {
+        return;
+    }
+
+    // Collect the times for each stage, plus the total for each frame
+    const int numStages = StageTiming::Stage_ARRAYSIZE;
+    vector<vector<float>> times(numStages + 1);
+    const int n = min<int>(numFrames, _history->size());
+    for (int i = 0; i < n; i++) {
+        const shared_ptr<LogFrame>& frame = (*_history)[i];
+        if (!frame || frame->stage_timing_size() == 0) {
+            continue;
+        }
+
+        float total = 0;
+        for (const StageTiming& timing : frame->stage_timing()) {
+            const float ms = timing.time() / 1000.0f;
+            times[timing.stage()].push_back(ms);
+            total += ms;
+        }
+        times[numStages].push_back(total);
+    }
+
+    vector<Percentiles> rows;
+    vector<QString> names;
+    float scale = 1;
+    for (int stage = 0; stage <= numStages; stage++) {
+        if (times[stage].empty()) {
+            continue;
+        }
+        rows.push_back(percentiles(times[stage]));
+        names.push_back(stage < numStages
+                            ? QString::fromStdString(StageTiming::Stage_Name(
+                                  (StageTiming::Stage)stage))
+                            : QString("Total"));
+        scale = max(scale, rows.back().p99);
+    }
+
+    QPainter p(this);
+    const QFontMetrics metrics(p.font());
+    const int rowHeight = metrics.height() + 4;
+    const int labelWidth = metrics.width("LogFrameAssembly") + 8;
+    const int valueWidth =
+        metrics.width("000.0 / 000.0 / 000.0 / 000.0 ms") + 8;
+    const int barWidth = max(10, width() - labelWidth - valueWidth);
+
+    p.setPen(Qt::gray);
+    p.drawText(0, rowHeight - 4,
+               QString("Last %1 frames (p50 / p90 / p99 / max)")
+                   .arg(times.back().size()));
+
+    for (size_t row = 0; row < rows.size(); row++) {
+        const Percentiles& pct = rows[row];
+        const int y = (row + 1) * rowHeight;
+        auto x = [&](float ms) {
+            return labelWidth + min(ms / scale, 1.0f) * barWidth;
+        };
+
+        p.setPen(Qt::white);
+        p.drawText(0, y + rowHeight - 4, names[row]);
+
+        // Darker bars for higher percentiles, drawn from the back
+        const int barTop = y + 2;
+        const int barHeight = rowHeight - 4;
+        p.fillRect(QRectF(labelWidth, barTop, x(pct.p99) - labelWidth,
+                          barHeight),
+                   QColor(120, 40, 40));
+        p.fillRect(QRectF(labelWidth, barTop, x(pct.p90) - labelWidth,
+                          barHeight),
+                   QColor(200, 140, 40));
+        p.fillRect(QRectF(labelWidth, barTop, x(pct.p50) - labelWidth,
+                          barHeight),
+                   QColor(60, 180, 60));
+
+        // Mark the maximum, which may be off the scale
+        p.setPen(Qt::red);
+        p.drawLine(QPointF(x(pct.max), barTop),
+                   QPointF(x(pct.max), barTop + barHeight));
+
+        // A single stall only shows up in the max, so it's always printed
+        p.setPen(Qt::white);
+        p.drawText(labelWidth + barWidth + 8, y + rowHeight - 4,
+                   QString("%1 / %2 / %3 / %4 ms")
+                       .arg(pct.p50, 0, 'f', 1)
+                       .arg(pct.p90, 0, 'f', 1)
+                       .arg(pct.p99, 0, 'f', 1)
+                       .arg(pct.max, 0, 'f', 1));
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QWidget>
+
+#include <memory>
+#include <vector>
+
+namespace Packet {
+class LogFrame;
+}
+
+/**
+ * @brief Shows the distribution of time spent in each stage of the processing
+ * loop over recent frames.
+ *
+ * @details Each stage recorded in LogFrame::stage_timing gets a row with bars
+ * for its 50th, 90th and 99th percentile and maximum times.  The last row is
+ * the total over all stages.
+ */
+class StageTimingWidget : public QWidget {
+public:
+    StageTimingWidget(QWidget* parent = nullptr);
+
+    /// Frames to take timings from, newest first.  Entries may be null.
+    void history(const std::vector<std::shared_ptr<Packet::LogFrame>>* value) {
+        _history = value;
+    }
+
+    /// Number of frames from the front of the history to use
+    int numFrames = 600;
+
+protected:
+    void paintEvent(QPaintEvent* e) override;
+
+private:
+    const std::vector<std::shared_ptr<Packet::LogFrame>>* _history = nullptr;
+};
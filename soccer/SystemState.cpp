@@ -1,3 +1,4 @@
+#include <mutex>
 #include <optional>
 
 #include <protobuf/LogFrame.pb.h>
@@ -160,6 +161,11 @@ double Ball::estimateSecondsToDist(double dist) const {
     }
 }
 
+// Guards the debug layers and the debug drawings in the logFrame.  Recursive
+// because the drawing functions call each other.  This lives outside of
+// SystemState so that SystemState stays copyable for the python bindings.
+static std::recursive_mutex drawMutex;
+
 SystemState::SystemState() {
     _numDebugLayers = 0;
 
@@ -180,6 +186,7 @@ SystemState::~SystemState() {
 }
 
 int SystemState::findDebugLayer(QString layer) {
+    std::lock_guard<std::recursive_mutex> lock(drawMutex);
     if (layer.isNull()) {
         layer = "Debug";
     }
@@ -199,6 +206,7 @@ int SystemState::findDebugLayer(QString layer) {
 
 void SystemState::drawPolygon(const Geometry2d::Point* pts, int n,
                               const QColor& qc, const QString& layer) {
+    std::lock_guard<std::recursive_mutex> lock(drawMutex);
     DebugPath* dbg = logFrame->add_debug_polygons();
     dbg->set_layer(findDebugLayer(layer));
     for (int i = 0; i < n; ++i) {
@@ -219,6 +227,7 @@ void SystemState::drawPolygon(const Geometry2d::Polygon& polygon,
 
 void SystemState::drawCircle(Geometry2d::Point center, float radius,
                              const QColor& qc, const QString& layer) {
+    std::lock_guard<std::recursive_mutex> lock(drawMutex);
     DebugCircle* dbg = logFrame->add_debug_circles();
     dbg->set_layer(findDebugLayer(layer));
     *dbg->mutable_center() = center;
@@ -228,6 +237,7 @@ void SystemState::drawCircle(Geometry2d::Point center, float radius,
 
 void SystemState::drawArc(const Geometry2d::Arc& arc, const QColor& qc,
                           const QString& layer) {
+    std::lock_guard<std::recursive_mutex> lock(drawMutex);
     DebugArc* dbg = logFrame->add_debug_arcs();
     dbg->set_layer(findDebugLayer(layer));
     *dbg->mutable_center() = arc.center();
@@ -265,6 +275,7 @@ void SystemState::drawShapeSet(const Geometry2d::ShapeSet& shapes,
 
 void SystemState::drawLine(const Geometry2d::Segment& line, const QColor& qc,
                            const QString& layer) {
+    std::lock_guard<std::recursive_mutex> lock(drawMutex);
     DebugPath* dbg = logFrame->add_debug_paths();
     dbg->set_layer(findDebugLayer(layer));
     *dbg->add_points() = line.pt[0];
@@ -279,6 +290,7 @@ void SystemState::drawLine(Geometry2d::Point p0, Geometry2d::Point p1,
 
 void SystemState::drawText(const QString& text, Geometry2d::Point pos,
                            const QColor& qc, const QString& layer) {
+    std::lock_guard<std::recursive_mutex> lock(drawMutex);
     DebugText* dbg = logFrame->add_debug_texts();
     dbg->set_layer(findDebugLayer(layer));
     dbg->set_text(text.toStdString());
@@ -288,6 +300,7 @@ void SystemState::drawText(const QString& text, Geometry2d::Point pos,
 
 void SystemState::drawSegment(const Geometry2d::Segment& line, const QColor& qc,
                               const QString& layer) {
+    std::lock_guard<std::recursive_mutex> lock(drawMutex);
     DebugPath* dbg = logFrame->add_debug_paths();
     dbg->set_layer(findDebugLayer(layer));
     *dbg->add_points() = line.pt[0];
@@ -36,6 +36,9 @@ class Ball {
 public:
     Geometry2d::Point pos;
     Geometry2d::Point vel;
+    /// average position and velocity covariance of the vision filter
+    double posCov = 0;
+    double velCov = 0;
     RJ::Time time;
     bool valid = false;
 
@@ -78,6 +81,9 @@ public:
      * Each drawing function also associates the drawn content with a particular
      * 'layer'.  Separating drawing items into layers lets you choose at runtime
      * which items actually get drawn.
+     *
+     * The drawing functions may be called from several threads at once (e.g.
+     * path planners running in parallel).
      */
 
     /** @ingroup drawing_functions */
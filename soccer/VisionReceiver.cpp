@@ -1,8 +1,17 @@
 #include "VisionReceiver.hpp"
 
 #include <unistd.h>
-#include <QMutexLocker>
 #include <QUdpSocket>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
 #include <Utils.hpp>
 #include <multicast.hpp>
 #include <stdexcept>
@@ -10,7 +19,7 @@
 using namespace std;
 
 VisionReceiver::VisionReceiver(bool sim, int port)
-    : simulation(sim), _running(false), port(port) {}
+    : simulation(sim), _running(false), port(port), _slots(BufferSize) {}
 
 void VisionReceiver::stop() {
     if (isRunning()) {
@@ -24,39 +33,120 @@ void VisionReceiver::stop() {
 }
 
 void VisionReceiver::getPackets(std::vector<VisionPacket*>& packets) {
-    _mutex.lock();
-    packets = _packets;
-    _packets.clear();
-    _mutex.unlock();
+    packets.clear();
+    _consumed = _head.load(std::memory_order_acquire);
+    for (uint64_t i = _tail.load(std::memory_order_relaxed); i < _consumed;
+         i++) {
+        packets.push_back(&_slots[i % BufferSize]);
+    }
+}
+
+void VisionReceiver::releasePackets() {
+    _tail.store(_consumed, std::memory_order_release);
+}
+
+bool VisionReceiver::waitForPackets(RJ::Time deadline) {
+    std::unique_lock<std::mutex> lock(_waitMutex);
+    _waiting = true;
+    // Pairs with the fence in notifyWaiters(): either the receive thread
+    // sees _waiting, or this thread sees the packet it published
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool available = _packetAdded.wait_until(lock, deadline, [this] {
+        return _head.load(std::memory_order_acquire) !=
+               _tail.load(std::memory_order_relaxed);
+    });
+    _waiting = false;
+    return available;
 }
 
+#ifdef __linux__
+namespace {
+
+/// Datagrams read per recvmmsg() call
+constexpr int ReceiveBatchSize = 16;
+
+constexpr size_t MaxDatagramSize = 65536;
+
+/// Opens a UDP socket on @port for the native receive path, joined to the
+/// shared vision multicast group.
+///
+/// @return the socket, or -1 if it couldn't be set up
+int openNativeSocket(int port) {
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    // Same as QUdpSocket::ShareAddress
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    // Without kernel timestamps we fall back to the time we read the packet
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) != 0) {
+        fprintf(stderr, "VisionReceiver: SO_TIMESTAMPNS: %s\n",
+                strerror(errno));
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    struct ip_mreqn mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_multiaddr.s_addr = inet_addr(SharedVisionAddress);
+    setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+
+    return fd;
+}
+
+RJ::Time fromTimespec(const struct timespec& ts) {
+    return RJ::Time(std::chrono::duration_cast<RJ::Time::duration>(
+        std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+}
+
+}  // namespace
+#endif
+
 void VisionReceiver::run() {
     _running = true;
-    QUdpSocket socket;
+    const int bindPort = simulation ? SimVisionPort : port;
 
-    // Create vision socket
-    if (simulation) {
-        if (!socket.bind(SimVisionPort, QUdpSocket::ShareAddress)) {
-            throw runtime_error("Can't bind to shared vision port");
-        }
-
-        multicast_add(&socket, SharedVisionAddress);
-    } else {
-        // Receive multicast packets from shared vision.
-        if (!socket.bind(port, QUdpSocket::ShareAddress)) {
-            throw runtime_error("Can't bind to shared vision port");
+#ifdef __linux__
+    if (nativeSocket) {
+        int fd = openNativeSocket(bindPort);
+        if (fd >= 0) {
+            _usingNativeSocket = true;
+            runNative(fd);
+            ::close(fd);
+            _usingNativeSocket = false;
+            return;
         }
+        fprintf(stderr,
+                "VisionReceiver: can't open native socket on port %d (%s), "
+                "falling back to QUdpSocket\n",
+                bindPort, strerror(errno));
+    }
+#endif
 
-        multicast_add(&socket, SharedVisionAddress);
+    // Receive multicast packets from shared vision (or the simulator)
+    QUdpSocket socket;
+    if (!socket.bind(bindPort, QUdpSocket::ShareAddress)) {
+        throw runtime_error("Can't bind to shared vision port");
     }
+    multicast_add(&socket, SharedVisionAddress);
 
-    // There should be at most four packets: one for each camera on each of two
-    // frames, assuming some clock skew between this
-    // computer and the vision computer.
-    _packets.reserve(4);
-    while (_running) {
-        char buf[65536];
+    runQt(socket);
+}
 
+void VisionReceiver::runQt(QUdpSocket& socket) {
+    char buf[65536];
+    while (_running) {
         // Wait for a UDP packet
         if (!socket.waitForReadyRead(500)) {
             // Time out once in a while so the thread has a chance to exit
@@ -77,20 +167,123 @@ void VisionReceiver::run() {
         // FIXME - Verify that it is from the right host, in case there are
         // multiple visions on the network
 
-        // Parse the protobuf message
-        VisionPacket* packet = new VisionPacket;
-        packet->receivedTime = RJ::now();
-        if (!packet->wrapper.ParseFromArray(buf, size)) {
+        if (!addPacket(buf, size, RJ::now())) {
             fprintf(stderr,
                     "VisionReceiver: got bad packet of %d bytes from %s:%d\n",
                     (int)size, (const char*)host.toString().toLatin1(),
                     portNumber);
+        }
+        notifyWaiters();
+    }
+}
+
+#ifdef __linux__
+void VisionReceiver::runNative(int fd) {
+    // Everything recvmmsg() needs is allocated once up front
+    std::vector<char> buffers(ReceiveBatchSize * MaxDatagramSize);
+    struct mmsghdr messages[ReceiveBatchSize];
+    struct iovec iovecs[ReceiveBatchSize];
+    struct sockaddr_in sources[ReceiveBatchSize];
+    union {
+        char buf[CMSG_SPACE(sizeof(struct timespec))];
+        struct cmsghdr align;
+    } control[ReceiveBatchSize];
+
+    while (_running) {
+        // Wait for a UDP packet, timing out once in a while so the thread has
+        // a chance to exit
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 500) <= 0) {
             continue;
         }
 
-        // Add to the vector of packets
-        _mutex.lock();
-        _packets.push_back(packet);
-        _mutex.unlock();
+        // The kernel overwrites the lengths, so reset them for every call
+        memset(messages, 0, sizeof(messages));
+        for (int i = 0; i < ReceiveBatchSize; i++) {
+            iovecs[i].iov_base = &buffers[i * MaxDatagramSize];
+            iovecs[i].iov_len = MaxDatagramSize;
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &sources[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sources[i]);
+            messages[i].msg_hdr.msg_control = control[i].buf;
+            messages[i].msg_hdr.msg_controllen = sizeof(control[i].buf);
+        }
+
+        // Take everything that's pending without blocking
+        int count =
+            recvmmsg(fd, messages, ReceiveBatchSize, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "VisionReceiver: %s\n", strerror(errno));
+                // See Processor for why we can't use QThread::msleep()
+                ::usleep(100 * 1000);
+            }
+            continue;
+        }
+
+        const RJ::Time readTime = RJ::now();
+        for (int i = 0; i < count; i++) {
+            const struct msghdr& header = messages[i].msg_hdr;
+
+            RJ::Time receivedTime = readTime;
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg;
+                 cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&header),
+                                    cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET &&
+                    cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    struct timespec ts;
+                    memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                    receivedTime = fromTimespec(ts);
+                }
+            }
+
+            const size_t size = messages[i].msg_len;
+            if ((header.msg_flags & MSG_TRUNC) ||
+                !addPacket(&buffers[i * MaxDatagramSize], size,
+                           receivedTime)) {
+                char host[INET_ADDRSTRLEN] = "?";
+                inet_ntop(AF_INET, &sources[i].sin_addr, host, sizeof(host));
+                fprintf(stderr,
+                        "VisionReceiver: got bad packet of %d bytes from "
+                        "%s:%d\n",
+                        (int)size, host, ntohs(sources[i].sin_port));
+            }
+        }
+        notifyWaiters();
+    }
+}
+#endif
+
+bool VisionReceiver::addPacket(const char* data, size_t size,
+                               RJ::Time receivedTime) {
+    // Find a free slot.  Only this thread changes _head.
+    const uint64_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= BufferSize) {
+        _droppedPackets++;
+        return true;
+    }
+
+    // Parse the protobuf message into the slot.  Parsing Clear()s the
+    // message first, which keeps its allocated submessages for reuse.
+    VisionPacket& packet = _slots[head % BufferSize];
+    packet.receivedTime = receivedTime;
+    if (!packet.wrapper.ParseFromArray(data, size)) {
+        return false;
+    }
+
+    // Publish the packet
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void VisionReceiver::notifyWaiters() {
+    // Keep the load of _waiting from moving ahead of the _head store
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiting) {
+        // Lock so the wakeup can't land between the waiter checking for
+        // packets and going to sleep
+        { std::lock_guard<std::mutex> lock(_waitMutex); }
+        _packetAdded.notify_all();
     }
 }
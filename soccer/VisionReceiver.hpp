@@ -5,7 +5,9 @@
 #include <Utils.hpp>
 
 #include <QThread>
-#include <QMutex>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 #include <stdint.h>
 
@@ -28,9 +30,21 @@ public:
  * UDP port for packets. If sim = true, it tries both simulator ports until one
  * works. Otherwise, it connects to the port specified in the constructor.
  *
+ * On Linux the socket is read directly with recvmmsg(), which drains every
+ * pending datagram in one call, and each packet's receivedTime is the kernel's
+ * arrival timestamp (SO_TIMESTAMPNS) rather than the time the thread woke up.
+ * If that socket can't be set up, or nativeSocket is false, the receiver falls
+ * back to a QUdpSocket.
+ *
  * Whenever a new packet comes in (encoded as Google Protobuf), it is parsed
- * into an SSL_WrapperPacket and placed onto the circular buffer @_packets.
- * They remain there until they are retrieved with getPackets().
+ * into the next free slot of a preallocated ring buffer.  The slots' protobuf
+ * messages are reused, so once the buffer has warmed up receiving a packet
+ * doesn't allocate.  Packets remain in the ring until they are retrieved with
+ * getPackets() and handed back with releasePackets().
+ *
+ * The ring has a single producer (the receive thread) and a single consumer
+ * (the thread calling getPackets()), so neither side takes a lock.  If the
+ * consumer falls behind and the ring fills up, new packets are dropped.
  */
 class VisionReceiver : public QThread {
 public:
@@ -38,22 +52,78 @@ public:
 
     void stop();
 
-    /// Copies the vector of packets and then clears it. The vector contains
-    /// only packets received since the last time this was called (or since the
-    /// VisionReceiver was started, if getPackets has never been called).
+    /// Fills @packets with the packets received since the last call to
+    /// releasePackets(), oldest first.
     ///
-    /// The caller is responsible for freeing the packets after this function
-    /// returns.
+    /// The packets stay valid (and may be modified) until releasePackets() is
+    /// called, after which their slots are reused.
     void getPackets(std::vector<VisionPacket*>& packets);
 
+    /// Returns the packets from the last call to getPackets() to the receive
+    /// thread
+    void releasePackets();
+
+    /// Blocks until there are packets waiting to be read by getPackets() or
+    /// until @deadline, whichever comes first.
+    ///
+    /// @return true if there are packets waiting
+    bool waitForPackets(RJ::Time deadline);
+
+    /// Number of packets dropped because the ring was full
+    uint64_t droppedPackets() const { return _droppedPackets; }
+
     bool simulation;
     int port;
 
+    /// Use the recvmmsg() receive path where it's available.  Must be set
+    /// before start().
+    bool nativeSocket = true;
+
+    /// True once the receive thread is reading with recvmmsg()
+    bool usingNativeSocket() const { return _usingNativeSocket; }
+
+    /// Number of packets the ring can hold
+    static constexpr size_t BufferSize = 64;
+
 protected:
     virtual void run() override;
 
-    volatile bool _running;
-    /// This mutex protects the vector of packets
-    QMutex _mutex;
-    std::vector<VisionPacket*> _packets;
+    /// Receive loops for each kind of socket.  They return when _running is
+    /// cleared.
+    void runQt(QUdpSocket& socket);
+#ifdef __linux__
+    void runNative(int fd);
+#endif
+
+    /// Parses a datagram into the next free slot and publishes it.  Doesn't
+    /// wake waitForPackets(); call notifyWaiters() after a batch.
+    ///
+    /// @return false if the datagram wasn't a valid packet
+    bool addPacket(const char* data, size_t size, RJ::Time receivedTime);
+
+    void notifyWaiters();
+
+    std::atomic<bool> _running;
+    std::atomic<bool> _usingNativeSocket{false};
+
+    /// Ring of packet slots.  Slot i % BufferSize holds the i'th packet
+    /// received.
+    std::vector<VisionPacket> _slots;
+
+    /// Number of packets written by the receive thread
+    std::atomic<uint64_t> _head{0};
+
+    /// Number of packets released by the consumer
+    std::atomic<uint64_t> _tail{0};
+
+    /// Value of _head at the last call to getPackets()
+    uint64_t _consumed = 0;
+
+    std::atomic<uint64_t> _droppedPackets{0};
+
+    /// Used by waitForPackets() to sleep until a packet arrives.  The receive
+    /// thread only signals when someone is waiting.
+    std::mutex _waitMutex;
+    std::condition_variable _packetAdded;
+    std::atomic<bool> _waiting{false};
 };
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "VisionReceiver.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Unlikely to be in use by a real vision system on the test machine
+const int TestPort = 10918;
+
+/**
+ * Replays vision packets to a port on the loopback interface at a fixed rate,
+ * standing in for ssl-vision.
+ */
+class VisionReplayer {
+public:
+    explicit VisionReplayer(int port) {
+        _fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        memset(&_dest, 0, sizeof(_dest));
+        _dest.sin_family = AF_INET;
+        _dest.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        _dest.sin_port = htons(port);
+    }
+
+    ~VisionReplayer() { ::close(_fd); }
+
+    void send(const string& data) {
+        sendto(_fd, data.data(), data.size(), 0, (struct sockaddr*)&_dest,
+               sizeof(_dest));
+    }
+
+    /// Sends @packets in order at @rate packets per second, or as fast as
+    /// possible if @rate is zero.
+    void replay(const vector<SSL_WrapperPacket>& packets, double rate) {
+        const RJ::Time start = RJ::now();
+        for (size_t i = 0; i < packets.size(); i++) {
+            if (rate > 0) {
+                this_thread::sleep_until(start + RJ::Seconds(i / rate));
+            }
+            send(packets[i].SerializeAsString());
+        }
+    }
+
+private:
+    int _fd;
+    struct sockaddr_in _dest;
+};
+
+/// Makes @frames frames of detections from each of @cameras cameras, in the
+/// order they would be sent
+vector<SSL_WrapperPacket> makePackets(int cameras, int frames) {
+    vector<SSL_WrapperPacket> packets;
+    for (int frame = 0; frame < frames; frame++) {
+        for (int camera = 0; camera < cameras; camera++) {
+            packets.emplace_back();
+            SSL_DetectionFrame* det = packets.back().mutable_detection();
+            det->set_frame_number(frame);
+            det->set_t_capture(frame / 60.0);
+            det->set_t_sent(frame / 60.0);
+            det->set_camera_id(camera);
+            SSL_DetectionBall* ball = det->add_balls();
+            ball->set_confidence(1);
+            ball->set_x(camera);
+            ball->set_y(frame);
+            ball->set_pixel_x(0);
+            ball->set_pixel_y(0);
+        }
+    }
+    return packets;
+}
+
+/// Reads packets from @receiver until @count have arrived or a second passes
+/// without any
+vector<VisionPacket> receive(VisionReceiver& receiver, size_t count) {
+    vector<VisionPacket> received;
+    vector<VisionPacket*> packets;
+    while (received.size() < count &&
+           receiver.waitForPackets(RJ::now() + RJ::Seconds(1))) {
+        receiver.getPackets(packets);
+        for (VisionPacket* packet : packets) {
+            received.push_back(*packet);
+        }
+        receiver.releasePackets();
+    }
+    return received;
+}
+
+void checkReplay(bool nativeSocket, double rate, int frames) {
+    VisionReceiver receiver(false, TestPort);
+    receiver.nativeSocket = nativeSocket;
+    receiver.start();
+
+    // Give the receive thread time to bind
+    this_thread::sleep_for(100ms);
+#ifdef __linux__
+    EXPECT_EQ(nativeSocket, receiver.usingNativeSocket());
+#endif
+
+    vector<SSL_WrapperPacket> sent = makePackets(4, frames);
+    const RJ::Time start = RJ::now();
+    VisionReplayer replayer(TestPort);
+    thread sender([&] { replayer.replay(sent, rate); });
+
+    vector<VisionPacket> received = receive(receiver, sent.size());
+    sender.join();
+    receiver.stop();
+
+    ASSERT_EQ(sent.size(), received.size());
+    EXPECT_EQ(0, receiver.droppedPackets());
+    for (size_t i = 0; i < sent.size(); i++) {
+        EXPECT_EQ(sent[i].SerializeAsString(),
+                  received[i].wrapper.SerializeAsString());
+        EXPECT_GE(received[i].receivedTime, start);
+        if (i > 0) {
+            EXPECT_GE(received[i].receivedTime, received[i - 1].receivedTime);
+        }
+    }
+}
+
+}  // namespace
+
+// Four cameras at 60 Hz
+TEST(VisionReceiver, replayNative) { checkReplay(true, 4 * 60, 30); }
+
+TEST(VisionReceiver, replayQt) { checkReplay(false, 4 * 60, 30); }
+
+TEST(VisionReceiver, burstNative) {
+    // Everything arrives at once, so it's drained in batches.  This has to
+    // fit in the ring since the reader may not get a chance to run.
+    checkReplay(true, 0, VisionReceiver::BufferSize / 4);
+}
+
+TEST(VisionReceiver, badPacket) {
+    VisionReceiver receiver(false, TestPort);
+    receiver.start();
+    this_thread::sleep_for(100ms);
+
+    VisionReplayer replayer(TestPort);
+    replayer.send("not a vision packet");
+    replayer.replay(makePackets(1, 1), 0);
+
+    vector<VisionPacket> received = receive(receiver, 1);
+    receiver.stop();
+
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(0, received[0].wrapper.detection().camera_id());
+}
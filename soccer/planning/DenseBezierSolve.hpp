@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Geometry2d/Point.hpp>
+#include "RRTPlanner.hpp"
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace Planning {
+
+/// Gives tests and benchmarks access to RRTPlanner's Bezier helpers
+class BezierPlanner : public RRTPlanner {
+public:
+    using RRTPlanner::cubicBezierCalc;
+};
+
+/// The velocities cubicBezierCalc() should find, from the dense system of
+/// equations for the control points that RRTPlanner used to solve with QR
+inline std::vector<Geometry2d::Point> denseBezierVelocities(
+    Geometry2d::Point vi, Geometry2d::Point vf,
+    const std::vector<Geometry2d::Point>& points,
+    const std::vector<double>& ks) {
+    using Geometry2d::Point;
+
+    const int curvesNum = points.size() - 1;
+    const int size = curvesNum * 2;
+    Eigen::MatrixXd equations = Eigen::MatrixXd::Zero(size, size);
+    Eigen::MatrixXd answer(size, 2);
+
+    // Unknowns 2n and 2n + 1 are p1 and p2 of curve n.  The first and last
+    // are fixed by the start and end velocities.
+    equations(0, 0) = 1;
+    equations(1, size - 1) = 1;
+    const Point first = points[0] + vi / (3 * ks[0]);
+    const Point last = points[curvesNum] - vf / (3 * ks[curvesNum - 1]);
+    answer.row(0) << first.x(), first.y();
+    answer.row(1) << last.x(), last.y();
+
+    int i = 2;
+    for (int n = 0; n < curvesNum - 1; n++, i++) {
+        // Matching velocities where curves n and n + 1 meet
+        equations(i, n * 2 + 1) = ks[n];
+        equations(i, n * 2 + 2) = ks[n + 1];
+        const Point p = points[n + 1] * (ks[n] + ks[n + 1]);
+        answer.row(i) << p.x(), p.y();
+    }
+    for (int n = 0; n < curvesNum - 1; n++, i++) {
+        // Matching accelerations
+        const double k2 = ks[n] * ks[n];
+        const double nextK2 = ks[n + 1] * ks[n + 1];
+        equations(i, n * 2) = k2;
+        equations(i, n * 2 + 1) = -2 * k2;
+        equations(i, n * 2 + 2) = 2 * nextK2;
+        equations(i, n * 2 + 3) = -nextK2;
+        const Point p = points[n + 1] * (nextK2 - k2);
+        answer.row(i) << p.x(), p.y();
+    }
+
+    const Eigen::MatrixXd controls = equations.householderQr().solve(answer);
+    std::vector<Point> velocities;
+    for (int n = 0; n < curvesNum; n++) {
+        const Point p1(controls(n * 2, 0), controls(n * 2, 1));
+        velocities.push_back((p1 - points[n]) * 3 * ks[n]);
+    }
+    const Point p2(controls(size - 1, 0), controls(size - 1, 1));
+    velocities.push_back((points[curvesNum] - p2) * 3 * ks[curvesNum - 1]);
+    return velocities;
+}
+
+}  // namespace Planning
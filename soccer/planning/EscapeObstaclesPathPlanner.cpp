@@ -35,7 +35,7 @@ std::unique_ptr<Path> EscapeObstaclesPathPlanner::run(
     if (prevPath) optPrevPt = prevPath->end().motion.pos;
     const Point unblocked = findNonBlockedGoal(
         startInstant.pos, optPrevPt, obstacles, 300,
-        [&](const RRT::Tree<Point>& rrt) {
+        [&](const RRTTree& rrt) {
             if (*RRTConfig::EnableRRTDebugDrawing) {
                 DrawRRT(rrt, &planRequest.systemState, planRequest.shellID);
             }
@@ -60,26 +60,30 @@ std::unique_ptr<Path> EscapeObstaclesPathPlanner::run(
 
 Point EscapeObstaclesPathPlanner::findNonBlockedGoal(
     Point goal, std::optional<Point> prevGoal, const ShapeSet& obstacles,
-    int maxItr, std::function<void(const RRT::Tree<Point>&)> rrtLogger) {
+    int maxItr, std::function<void(const RRTTree&)> rrtLogger) {
     if (obstacles.hit(goal)) {
-        auto stateSpace = make_shared<RoboCupStateSpace>(
-            Field_Dimensions::Current_Dimensions, obstacles);
-        RRT::Tree<Point> rrt(stateSpace, Point::hash, 2);
-        rrt.setStartState(goal);
-        // note: we don't set goal state because we're not looking for a
+        const RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                           obstacles);
+
+        // The library's RRT::Tree picks with the global rand(), which races
+        // when robots are planned in parallel.  RRTTree leaves the picking to
+        // us, and the state space's random states are per-thread.
+        RRTTree rrt;
+        rrt.reset(goal);
+        // note: there's no goal state because we're not looking for a
         // particular point, just something that isn't blocked
-        rrt.setStepSize(stepSize());
 
         // The starting point is in an obstacle, extend the tree until we find
         // an unobstructed point
         Point newGoal;
         for (int i = 0; i < maxItr; ++i) {
             // extend towards a random point
-            RRT::Node<Point>* newNode = rrt.grow();
+            const int newNode =
+                rrt.extend(stateSpace, stateSpace.randomState(), stepSize());
 
             // if the new point is not blocked, it becomes the new goal
-            if (newNode && !obstacles.hit(newNode->state())) {
-                newGoal = newNode->state();
+            if (newNode >= 0 && !obstacles.hit(rrt.state(newNode))) {
+                newGoal = rrt.state(newNode);
                 break;
             }
         }
@@ -2,7 +2,7 @@
 #include <functional>
 
 #include <Geometry2d/Point.hpp>
-#include <rrt/Tree.hpp>
+#include "RRTTree.hpp"
 #include "SingleRobotPathPlanner.hpp"
 
 class Configuration;
@@ -30,8 +30,7 @@ public:
     static Geometry2d::Point findNonBlockedGoal(
         Geometry2d::Point pt, std::optional<Geometry2d::Point> prevPt,
         const Geometry2d::ShapeSet& obstacles, int maxItr = 300,
-        std::function<void(const RRT::Tree<Geometry2d::Point>&)> rrtLogger =
-            nullptr);
+        std::function<void(const RRTTree&)> rrtLogger = nullptr);
 
     static void createConfiguration(Configuration* cfg);
 
@@ -1,12 +1,50 @@
 #include "IndependentMultiRobotPathPlanner.hpp"
 #include "RobotConstraints.hpp"
 #include "InterpolatedPath.hpp"
+#include "RRTPlanner.hpp"
+
+#include <protobuf/LogFrame.pb.h>
 
 using namespace std;
 namespace Planning {
 
+REGISTER_CONFIGURABLE(IndependentMultiRobotPathPlanner);
+
+ConfigBool* IndependentMultiRobotPathPlanner::_parallelPlanning;
+ConfigInt* IndependentMultiRobotPathPlanner::_numPlanningThreads;
+ConfigBool* IndependentMultiRobotPathPlanner::_anytimePlanning;
+ConfigDouble* IndependentMultiRobotPathPlanner::_planningBudget;
+ConfigDouble* IndependentMultiRobotPathPlanner::_priorityBudgetWeight;
+
+void IndependentMultiRobotPathPlanner::createConfiguration(
+    Configuration* cfg) {
+    _parallelPlanning = new ConfigBool(
+        cfg, "PathPlanner/Parallel/enabled", false,
+        "Plan robots that don't depend on each other's paths at the same "
+        "time on a pool of worker threads");
+    _numPlanningThreads =
+        new ConfigInt(cfg, "PathPlanner/Parallel/numThreads", 4,
+                      "Number of worker threads used for parallel planning");
+    _anytimePlanning = new ConfigBool(
+        cfg, "PathPlanner/Anytime/enabled", false,
+        "Give each robot a deadline to plan by instead of a fixed amount of "
+        "work, splitting the planning budget between robots by priority");
+    _planningBudget =
+        new ConfigDouble(cfg, "PathPlanner/Anytime/budget", 0.008,
+                         "Seconds each frame's path planning should take");
+    _priorityBudgetWeight = new ConfigDouble(
+        cfg, "PathPlanner/Anytime/priorityWeight", 0.1,
+        "Extra share of the planning budget a robot gets for each point of "
+        "planning priority");
+}
+
+double IndependentMultiRobotPathPlanner::budgetWeight(int8_t priority) {
+    return 1 + std::max<int>(priority, 0) * *_priorityBudgetWeight;
+}
+
 std::map<int, std::unique_ptr<Path>> IndependentMultiRobotPathPlanner::run(
     std::map<int, PlanRequest> requests) {
+    const RJ::Time planningStart = RJ::now();
     std::map<int, std::unique_ptr<Path>> paths;
 
     std::map<int, shared_ptr<Geometry2d::Circle>> staticRobotObstacles;
@@ -45,47 +83,179 @@ std::map<int, std::unique_ptr<Path>> IndependentMultiRobotPathPlanner::run(
     std::sort(std::begin(dynamicRequests), std::end(dynamicRequests),
               comparator);
 
-    std::vector<int> inOrderRequests;
-    inOrderRequests.insert(std::end(inOrderRequests),
-                           std::begin(staticRequests),
-                           std::end(staticRequests));
-    inOrderRequests.insert(std::end(inOrderRequests),
-                           std::begin(dynamicRequests),
-                           std::end(dynamicRequests));
+    // Group the requests into batches.  Robots in the same batch don't depend
+    // on each other's paths, so they can be planned at the same time.  When
+    // planning serially, every robot gets its own batch so that a dynamic
+    // planner also sees the robots of the same priority planned before it.
+    const bool parallel = *_parallelPlanning;
+    std::vector<std::vector<int>> batches;
+    if (parallel) {
+        if (!staticRequests.empty()) {
+            batches.push_back(staticRequests);
+        }
+        for (size_t i = 0; i < dynamicRequests.size(); i++) {
+            if (i == 0 || requests.at(dynamicRequests[i]).priority !=
+                              requests.at(dynamicRequests[i - 1]).priority) {
+                batches.emplace_back();
+            }
+            batches.back().push_back(dynamicRequests[i]);
+        }
+
+        const size_t numThreads = std::max(_numPlanningThreads->value(), 1);
+        if (!_threadPool || _threadPool->size() != numThreads) {
+            _threadPool = std::make_unique<ThreadPool>(numThreads);
+        }
+    } else {
+        for (int shell : staticRequests) {
+            batches.push_back({shell});
+        }
+        for (int shell : dynamicRequests) {
+            batches.push_back({shell});
+        }
+    }
 
+    // Each batch's share of the planning budget.  The robots in a batch are
+    // planned at the same time, so the batch gets what its highest priority
+    // robot would.
+    const bool anytime = *_anytimePlanning;
+    const RJ::Time budgetEnd = planningStart + RJ::Seconds(*_planningBudget);
+    std::vector<double> batchWeights;
+    double remainingWeight = 0;
+    if (anytime) {
+        for (const std::vector<int>& batch : batches) {
+            double weight = 0;
+            for (int shell : batch) {
+                weight = std::max(weight,
+                                  budgetWeight(requests.at(shell).priority));
+            }
+            batchWeights.push_back(weight);
+            remainingWeight += weight;
+        }
+    }
+
+    std::map<int, RJ::Seconds> planTimes;
     vector<DynamicObstacle> ourRobotsObstacles;
-    for (int shell : inOrderRequests) {
-        PlanRequest& request = requests.at(shell);
+    _ourPathsGrid.reset(planningStart);
+    for (size_t b = 0; b < batches.size(); b++) {
+        const std::vector<int>& batch = batches[b];
 
-        if (_planners[shell]->canHandleDynamic()) {
-            std::copy(std::begin(ourRobotsObstacles),
-                      std::end(ourRobotsObstacles),
-                      std::back_inserter(request.dynamicObstacles));
-        } else {
-            for (auto& entry : staticRobotObstacles) {
-                if (entry.first != shell) {
-                    request.obstacles.add(entry.second);
+        if (anytime) {
+            // Split what's left of the budget between the remaining batches,
+            // so time one batch doesn't use goes to the ones after it
+            const RJ::Time now = RJ::now();
+            const RJ::Seconds left =
+                std::max(RJ::Seconds(budgetEnd - now), RJ::Seconds::zero());
+            const RJ::Time deadline =
+                now + left * (batchWeights[b] / remainingWeight);
+            remainingWeight -= batchWeights[b];
+            for (int shell : batch) {
+                requests.at(shell).deadline = deadline;
+            }
+        }
+
+        for (int shell : batch) {
+            PlanRequest& request = requests.at(shell);
+
+            if (_planners[shell]->canHandleDynamic()) {
+                std::copy(std::begin(ourRobotsObstacles),
+                          std::end(ourRobotsObstacles),
+                          std::back_inserter(request.dynamicObstacles));
+                request.dynamicGrid = &_ourPathsGrid;
+            } else {
+                for (auto& entry : staticRobotObstacles) {
+                    if (entry.first != shell) {
+                        request.obstacles.add(entry.second);
+                    }
                 }
+                SingleRobotPathPlanner::allDynamicToStatic(
+                    request.obstacles, request.dynamicObstacles);
+                request.dynamicObstacles = std::vector<DynamicObstacle>();
             }
-            SingleRobotPathPlanner::allDynamicToStatic(
-                request.obstacles, request.dynamicObstacles);
-            request.dynamicObstacles = std::vector<DynamicObstacle>();
         }
 
-        std::unique_ptr<Path> path = _planners[shell]->run(request);
-        if (!path) {
-            path = Planning::InterpolatedPath::emptyPath(request.start.pos);
-            debugLog("path was null!! " + to_string(shell) + ":" +
-                     to_string(request.motionCommand->getCommandType()));
+        std::vector<std::unique_ptr<Path>> batchPaths(batch.size());
+        std::vector<RJ::Seconds> batchTimes(batch.size());
+        auto planIndex = [&](size_t i) {
+            const RJ::Time start = RJ::now();
+            batchPaths[i] = planRobot(batch[i], requests.at(batch[i]));
+            batchTimes[i] = RJ::now() - start;
+        };
+
+        if (parallel && batch.size() > 1) {
+            std::vector<std::future<void>> results;
+            results.reserve(batch.size());
+            for (size_t i = 0; i < batch.size(); i++) {
+                results.push_back(
+                    _threadPool->enqueue([&planIndex, i]() { planIndex(i); }));
+            }
+
+            // Wait for the whole batch before get() can rethrow, since the
+            // jobs reference this stack frame.
+            for (auto& result : results) {
+                result.wait();
+            }
+            for (auto& result : results) {
+                result.get();
+            }
+        } else {
+            for (size_t i = 0; i < batch.size(); i++) {
+                planIndex(i);
+            }
         }
-        paths[shell] = std::move(path);
 
-        // Add our generated path to our list of our Robot Obstacles
-        ourRobotsObstacles.push_back(DynamicObstacle(
-            request.start.pos, Robot_Radius, paths[shell].get()));
+        for (size_t i = 0; i < batch.size(); i++) {
+            int shell = batch[i];
+            paths[shell] = std::move(batchPaths[i]);
+            planTimes[shell] = batchTimes[i];
+
+            // Add our generated path to our list of our Robot Obstacles.
+            // Nothing is planning now, so the grid can be changed.
+            ourRobotsObstacles.push_back(
+                DynamicObstacle(requests.at(shell).start.pos, Robot_Radius,
+                                paths[shell].get()));
+            _ourPathsGrid.add(ourRobotsObstacles.back());
+        }
+    }
+
+    // Log how long planning took so serial and parallel modes can be compared
+    if (!requests.empty()) {
+        SystemState& state = requests.begin()->second.systemState;
+        if (state.logFrame) {
+            state.logFrame->set_parallel_planning(parallel);
+            state.logFrame->set_planning_time(
+                RJ::numMicroseconds(RJ::now() - planningStart));
+            for (auto& entry : planTimes) {
+                Packet::PlannerTiming* timing =
+                    state.logFrame->add_planner_timing();
+                timing->set_shell(entry.first);
+                timing->set_plan_time(RJ::numMicroseconds(entry.second));
+
+                const auto* rrtPlanner = dynamic_cast<const RRTPlanner*>(
+                    _planners[entry.first].get());
+                if (rrtPlanner) {
+                    const RRTPlanner::ReplanStats& stats =
+                        rrtPlanner->replanStats();
+                    timing->set_path_repairs(stats.repairs);
+                    timing->set_full_replans(stats.replans);
+                    timing->set_repair_time_saved(
+                        RJ::numMicroseconds(stats.timeSaved()));
+                }
+            }
+        }
     }
 
     return paths;
 }
 
+std::unique_ptr<Path> IndependentMultiRobotPathPlanner::planRobot(
+    int shell, PlanRequest& request) {
+    std::unique_ptr<Path> path = _planners.at(shell)->run(request);
+    if (!path) {
+        path = Planning::InterpolatedPath::emptyPath(request.start.pos);
+        debugLog("path was null!! " + to_string(shell) + ":" +
+                 to_string(request.motionCommand->getCommandType()));
+    }
+    return path;
+}
+
 }  // namespace Planning
@@ -1,21 +1,64 @@
 #pragma once
 
+#include <ThreadPool.hpp>
 #include "MultiRobotPathPlanner.hpp"
 #include "SingleRobotPathPlanner.hpp"
+#include "SpaceTimeGrid.hpp"
 
 namespace Planning {
 
 /// Plans paths for a collection of robots using a SingleRobotPathPlanner for
 /// each.  This planner doesn't take other robots' paths into account when
 /// planning, which means that occasionally the planned paths will collide.
+///
+/// Robots whose planners only handle static obstacles are planned first,
+/// followed by the dynamic planners in order of descending priority.  Each
+/// dynamic planner sees the paths of every robot planned before it.
+///
+/// When parallel planning is enabled, robots that don't depend on each other's
+/// paths are planned at the same time on a pool of worker threads: all of the
+/// static planners together, then each priority tier of dynamic planners.
+///
+/// With anytime planning enabled, each request is given a deadline so planning
+/// takes about the same time every frame.  The frame's planning budget is
+/// split between robots by priority, and time a robot doesn't use goes to the
+/// robots planned after it.
+///
+/// The paths planned so far are also kept in a SpaceTimeGrid that's passed to
+/// the dynamic planners, so they can check their paths against only the robots
+/// that come near them.
 class IndependentMultiRobotPathPlanner : public MultiRobotPathPlanner {
 public:
     virtual std::map<int, std::unique_ptr<Path>> run(
         std::map<int, PlanRequest> requests) override;
 
+    static void createConfiguration(Configuration* cfg);
+
 private:
+    /// Runs the planner for a single robot, substituting an empty path if the
+    /// planner fails
+    std::unique_ptr<Path> planRobot(int shell, PlanRequest& request);
+
+    /// How much of the planning budget a robot with @priority gets, relative
+    /// to a robot with no priority
+    static double budgetWeight(int8_t priority);
+
     /// Map of shell id -> planner
     std::map<int, std::unique_ptr<SingleRobotPathPlanner>> _planners;
+
+    /// Worker threads used for parallel planning.  Created on first use.
+    std::unique_ptr<ThreadPool> _threadPool;
+
+    /// The paths planned so far this frame.  Kept between frames so its
+    /// memory is reused.
+    SpaceTimeGrid _ourPathsGrid;
+
+    static ConfigBool* _parallelPlanning;
+    static ConfigInt* _numPlanningThreads;
+
+    static ConfigBool* _anytimePlanning;
+    static ConfigDouble* _planningBudget;
+    static ConfigDouble* _priorityBudgetWeight;
 };
 
 }  // namespace Planning
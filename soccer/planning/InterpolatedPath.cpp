@@ -4,6 +4,9 @@
 #include <protobuf/LogFrame.pb.h>
 #include "SystemState.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
 using namespace std;
@@ -83,28 +86,255 @@ bool InterpolatedPath::hit(const Geometry2d::ShapeSet& obstacles,
 
     // This code disregards obstacles which the robot starts in. This allows the
     // robot to move out a obstacle if it is already in one.
-    std::set<std::shared_ptr<Shape>> startHitSet =
+    const ShapeSet::HitSet startHitSet =
         obstacles.hitSet(waypoints[start].pos());
 
     for (size_t i = start; i < waypoints.size() - 1; i++) {
-        std::set<std::shared_ptr<Shape>> newHitSet = obstacles.hitSet(
+        const ShapeSet::HitSet newHitSet = obstacles.hitSet(
             Segment(waypoints[i].pos(), waypoints[i + 1].pos()));
-        if (!newHitSet.empty()) {
-            for (std::shared_ptr<Shape> hit : newHitSet) {
-                // If it hits something, check if the hit was in the original
-                // hitSet
-                if (startHitSet.find(hit) == startHitSet.end()) {
-                    if (hitTime) {
-                        *hitTime = waypoints[i].time;
-                    }
-                    return true;
+        for (const Shape* hit : newHitSet) {
+            // If it hits something, check if the hit was in the original
+            // hitSet
+            if (std::find(startHitSet.begin(), startHitSet.end(), hit) ==
+                startHitSet.end()) {
+                if (hitTime) {
+                    *hitTime = waypoints[i].time;
                 }
+                return true;
             }
         }
     }
     return false;
 }
 
+namespace {
+
+// Index of the first of @waypoints after @t
+size_t waypointAfter(const vector<InterpolatedPath::Entry>& waypoints,
+                     RJ::Seconds t) {
+    size_t index = 0;
+    while (index < waypoints.size() && waypoints[index].time <= t) {
+        index++;
+    }
+    return index;
+}
+
+// Bounding box of part of a path
+struct Bounds {
+    Bounds(Point a, Point b)
+        : minX(std::min(a.x(), b.x())),
+          minY(std::min(a.y(), b.y())),
+          maxX(std::max(a.x(), b.x())),
+          maxY(std::max(a.y(), b.y())) {}
+
+    // Bounds of @waypoints from @start on
+    Bounds(const vector<InterpolatedPath::Entry>& waypoints, size_t start)
+        : Bounds(waypoints[start].pos(), waypoints[start].pos()) {
+        for (size_t i = start + 1; i < waypoints.size(); i++) {
+            const Point& p = waypoints[i].pos();
+            minX = std::min(minX, p.x());
+            minY = std::min(minY, p.y());
+            maxX = std::max(maxX, p.x());
+            maxY = std::max(maxY, p.y());
+        }
+    }
+
+    // Whether something in these bounds could be within @dist of something
+    // in @other
+    bool near(const Bounds& other, double dist) const {
+        return minX - dist < other.maxX && other.minX - dist < maxX &&
+               minY - dist < other.maxY && other.minY - dist < maxY;
+    }
+
+    double minX, minY, maxX, maxY;
+};
+
+// Steps through the straight segments between a path's waypoints in time
+// order.  Times are in seconds on another path, @offset seconds behind this
+// one's.  Before the first waypoint and after the last, it stays there.
+class SegmentCursor {
+public:
+    SegmentCursor(const vector<InterpolatedPath::Entry>& waypoints,
+                  RJ::Seconds offset, RJ::Seconds t)
+        : _waypoints(waypoints),
+          _offset(offset.count()),
+          _next(waypointAfter(waypoints, t + offset)) {
+        enterSegment();
+    }
+
+    /// Position at @t, which must be in the current segment
+    Point at(double t) const { return _origin + _vel * (t - _originTime); }
+
+    /// When the current segment ends
+    double endTime() const {
+        return _next < _waypoints.size()
+                   ? _waypoints[_next].time.count() - _offset
+                   : std::numeric_limits<double>::infinity();
+    }
+
+    Point vel() const { return _vel; }
+
+    void nextSegment() {
+        _next++;
+        enterSegment();
+    }
+
+private:
+    void enterSegment() {
+        if (_next == 0 || _next == _waypoints.size()) {
+            _origin = _next == 0 ? _waypoints.front().pos()
+                                 : _waypoints.back().pos();
+            _vel = Point();
+            _originTime = 0;
+            return;
+        }
+
+        const InterpolatedPath::Entry& from = _waypoints[_next - 1];
+        const InterpolatedPath::Entry& to = _waypoints[_next];
+        const double duration = (to.time - from.time).count();
+        _origin = from.pos();
+        _vel = duration > 0 ? (to.pos() - from.pos()) / duration : Point();
+        _originTime = from.time.count() - _offset;
+    }
+
+    const vector<InterpolatedPath::Entry>& _waypoints;
+    const double _offset;
+    size_t _next;
+    Point _origin;
+    Point _vel;
+    double _originTime;
+};
+
+// Finds the first time in [@startTime, end of @path] that @path comes within
+// @radius of @other.  Times are relative to the start of @path.  Both paths
+// are linear between the times of their waypoints, so the distance between
+// them is found exactly on each interval between those times.
+std::optional<RJ::Seconds> firstContact(const InterpolatedPath& path,
+                                        const InterpolatedPath& other,
+                                        RJ::Seconds startTime, double radius,
+                                        Point* otherPos) {
+    const double endTime = path.getDuration().count();
+    if (startTime.count() >= endTime) {
+        return std::nullopt;
+    }
+
+    SegmentCursor a(path.waypoints, RJ::Seconds::zero(), startTime);
+    SegmentCursor b(other.waypoints, path.startTime() - other.startTime(),
+                    startTime);
+    const double radiusSq = radius * radius;
+
+    for (double t = startTime.count(); t < endTime;) {
+        // The interval ends at the next waypoint of either path
+        const double next = std::min({endTime, a.endTime(), b.endTime()});
+        const Point aPos = a.at(t);
+        const Point bPos = b.at(t);
+
+        // Only intervals where the robots' boxes come close can hit
+        if (Bounds(aPos, a.at(next)).near(Bounds(bPos, b.at(next)), radius)) {
+            // Solve |d + dv * s| = radius for the first s in [0, next - t],
+            // where d is the offset between the robots at t
+            const Point d = aPos - bPos;
+            const Point dv = a.vel() - b.vel();
+            const double qa = dv.magsq();
+            const double qb = 2 * d.dot(dv);
+            const double qc = d.magsq() - radiusSq;
+            if (qc < 0) {
+                *otherPos = bPos;
+                return RJ::Seconds(t);
+            }
+
+            const double discriminant = qb * qb - 4 * qa * qc;
+            if (qa > 0 && discriminant > 0) {
+                const double s = (-qb - std::sqrt(discriminant)) / (2 * qa);
+                if (s >= 0 && s <= next - t) {
+                    *otherPos = b.at(t + s);
+                    return RJ::Seconds(t + s);
+                }
+            }
+        }
+
+        if (a.endTime() <= next) {
+            a.nextSegment();
+        }
+        if (b.endTime() <= next) {
+            b.nextSegment();
+        }
+        t = next;
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+bool InterpolatedPath::pathsIntersect(
+    const std::vector<DynamicObstacle>& obstacles, RJ::Time startTime,
+    Point* hitLocation, RJ::Seconds* hitTime) const {
+    // Slowed paths aren't linear in the waypoint times
+    if (evalRate != 1 || waypoints.size() < 2) {
+        return Path::pathsIntersect(obstacles, startTime, hitLocation, hitTime);
+    }
+
+    const RJ::Seconds startTimeIntoPath = startTime - this->startTime();
+
+    // Like Path::pathsIntersect(), a hit on a static obstacle is returned
+    // before checking any moving ones
+    for (const DynamicObstacle& obs : obstacles) {
+        if (!obs.hasPath()) {
+            ShapeSet set;
+            set.add(obs.getStaticObstacle());
+            if (hit(set, startTimeIntoPath, hitTime)) {
+                return true;
+            }
+        }
+    }
+
+    // Where this path goes from the start time on, so obstacles that never
+    // come near it can be skipped
+    const size_t startIndex = waypointAfter(waypoints, startTimeIntoPath);
+    const Bounds bounds(waypoints, startIndex > 0 ? startIndex - 1 : 0);
+
+    std::optional<RJ::Seconds> first;
+    Point firstLocation;
+    for (const DynamicObstacle& obs : obstacles) {
+        if (!obs.hasPath()) {
+            continue;
+        }
+
+        std::optional<RJ::Seconds> contact;
+        Point location;
+        const auto* other =
+            dynamic_cast<const InterpolatedPath*>(obs.getPath());
+        if (other && other->evalRate == 1 && !other->waypoints.empty()) {
+            const double radius = obs.getRadius() + Robot_Radius;
+            if (bounds.near(Bounds(other->waypoints, 0), radius)) {
+                contact = firstContact(*this, *other, startTimeIntoPath,
+                                       radius, &location);
+            }
+        } else {
+            RJ::Seconds time;
+            if (Path::pathsIntersect({obs}, startTime, &location, &time)) {
+                contact = time;
+            }
+        }
+
+        if (contact && (!first || *contact < *first)) {
+            first = contact;
+            firstLocation = location;
+        }
+    }
+
+    if (!first) {
+        return false;
+    }
+    if (hitTime) {
+        *hitTime = *first;
+    }
+    if (hitLocation) {
+        *hitLocation = firstLocation;
+    }
+    return true;
+}
+
 float InterpolatedPath::distanceTo(Point pt) const {
     int i = nearestIndex(pt);
     if (i < 0) {
@@ -229,22 +459,36 @@ std::optional<RobotInstant> InterpolatedPath::eval(RJ::Seconds t) const {
     if (t < waypoints[0].time) {
         debugThrow(
             invalid_argument("The start time should not be less than zero"));
+        return RobotInstant(waypoints.front().instant);
     }
 
-    int i = 0;
-    while (waypoints[i].time <= t) {
-        if (waypoints[i].time == t) {
-            return RobotInstant(waypoints[i].instant);
-        }
-        i++;
-        if (i == size()) {
-            return std::nullopt;
+    return evalBefore(t, firstAfter(t));
+}
+
+size_t InterpolatedPath::firstAfter(RJ::Seconds t) const {
+    const auto next = std::upper_bound(
+        waypoints.begin(), waypoints.end(), t,
+        [](RJ::Seconds t, const Entry& entry) { return t < entry.time; });
+    return next - waypoints.begin();
+}
+
+std::optional<RobotInstant> InterpolatedPath::evalBefore(RJ::Seconds t,
+                                                         size_t next) const {
+    // A waypoint at exactly t is returned as is.  If several are, it's the
+    // first one.
+    if (waypoints[next - 1].time == t) {
+        size_t i = next - 1;
+        while (i > 0 && waypoints[i - 1].time == t) {
+            i--;
         }
-    }
-    RJ::Seconds deltaT = (waypoints[i].time - waypoints[i - 1].time);
-    if (deltaT == RJ::Seconds::zero()) {
         return RobotInstant(waypoints[i].instant);
     }
+    if (next == waypoints.size()) {
+        return std::nullopt;
+    }
+
+    const size_t i = next;
+    RJ::Seconds deltaT = (waypoints[i].time - waypoints[i - 1].time);
     float constant = (t - waypoints[i - 1].time) / deltaT;
 
     return RobotInstant(MotionInstant(waypoints[i - 1].pos() * (1 - constant) +
@@ -253,6 +497,43 @@ std::optional<RobotInstant> InterpolatedPath::eval(RJ::Seconds t) const {
                                           waypoints[i].vel() * (constant)));
 }
 
+std::optional<RobotInstant> InterpolatedPath::Cursor::evaluate(
+    RJ::Seconds t) {
+    const std::vector<Entry>& waypoints = _path.waypoints;
+    const RJ::Seconds pathTime = t * _path.evalRate;
+    if (pathTime < RJ::Seconds::zero() || waypoints.size() < 2 ||
+        pathTime < waypoints[0].time) {
+        return _path.evaluate(t);
+    }
+
+    // Step forward from the last segment, or search the whole path if t went
+    // back before it
+    if (_next == 0 || waypoints[_next - 1].time > pathTime) {
+        _next = _path.firstAfter(pathTime);
+    } else {
+        while (_next < waypoints.size() &&
+               waypoints[_next].time <= pathTime) {
+            _next++;
+        }
+    }
+
+    auto instant = _path.evalBefore(pathTime, _next);
+    if (instant) {
+        instant->motion.vel *= _path.evalRate;
+    }
+    return instant;
+}
+
+RobotInstant InterpolatedPath::Iterator::operator*() const {
+    auto instant = _cursor.evaluate(time);
+    return instant ? *instant : path->end();
+}
+
+std::unique_ptr<ConstPathIterator> InterpolatedPath::iterator(
+    RJ::Time startTime, RJ::Seconds deltaT) const {
+    return std::make_unique<Iterator>(*this, startTime, deltaT);
+}
+
 size_t InterpolatedPath::size() const { return waypoints.size(); }
 
 RJ::Seconds InterpolatedPath::getTime(int index) const {
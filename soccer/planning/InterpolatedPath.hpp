@@ -70,6 +70,18 @@ public:
     virtual RJ::Seconds getDuration() const override;
     virtual std::unique_ptr<Path> clone() const override;
 
+    /**
+     * Checks for collisions with obstacles that follow InterpolatedPaths
+     * exactly, since positions are linear in time between waypoints.  The
+     * earliest time the robots get too close is found analytically on each
+     * interval between waypoints of either path, so crossings between samples
+     * aren't missed.  Other obstacles are checked by Path::pathsIntersect().
+     */
+    virtual bool pathsIntersect(const std::vector<DynamicObstacle>& obstacles,
+                                RJ::Time startTime,
+                                Geometry2d::Point* hitLocation,
+                                RJ::Seconds* hitTime) const override;
+
     bool empty() const { return waypoints.empty(); }
 
     /// Erase all path contents
@@ -126,8 +138,52 @@ public:
         return std::move(path);
     }
 
+    /**
+     * Evaluates a path at a series of times, like evaluate(), but keeps the
+     * segment it found last time.  When the times go forward, finding the
+     * next segment is amortized O(1) instead of a search of the whole path.
+     * The path must not change while the cursor is in use.
+     */
+    class Cursor {
+    public:
+        explicit Cursor(const InterpolatedPath& path) : _path(path) {}
+
+        /// Same as evaluate(@t) on the path
+        std::optional<RobotInstant> evaluate(RJ::Seconds t);
+
+    private:
+        const InterpolatedPath& _path;
+
+        /// Index of the first waypoint after the last time evaluated
+        size_t _next = 0;
+    };
+
+    /// Steps along the path with a Cursor
+    virtual std::unique_ptr<ConstPathIterator> iterator(
+        RJ::Time startTime, RJ::Seconds deltaT) const override;
+
 protected:
     virtual std::optional<RobotInstant> eval(RJ::Seconds t) const override;
+
+private:
+    class Iterator : public ConstPathIterator {
+    public:
+        Iterator(const InterpolatedPath& path, RJ::Time startTime,
+                 RJ::Seconds deltaT)
+            : ConstPathIterator(&path, startTime, deltaT), _cursor(path) {}
+
+        RobotInstant operator*() const override;
+
+    private:
+        mutable Cursor _cursor;
+    };
+
+    /// Index of the first waypoint after @t, or size() if there isn't one
+    size_t firstAfter(RJ::Seconds t) const;
+
+    /// eval(@t) given @next, the index of the first waypoint after @t.  @t
+    /// can't be before the first waypoint.
+    std::optional<RobotInstant> evalBefore(RJ::Seconds t, size_t next) const;
 };
 
 }  // namespace Planning
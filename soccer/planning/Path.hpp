@@ -292,7 +292,7 @@ public:
         return *this;
     }
 
-private:
+protected:
     const Path* const path;
     RJ::Seconds time;
     const RJ::Seconds deltaT;
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <Benchmark.hpp>
+#include <Constants.hpp>
+#include <planning/InterpolatedPath.hpp>
+#include <planning/SpaceTimeGrid.hpp>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+using namespace Geometry2d;
+
+namespace Planning {
+
+namespace {
+
+/// A path across the field at y = @lane starting @ahead meters in front of the
+/// robot at x = -2.5, with waypoints spaced like the ones RRTPlanner makes (up
+/// to 40 per Bezier segment)
+InterpolatedPath lanePath(double ahead, RJ::Time startTime, double lane = 1) {
+    std::mt19937 gen(ahead * 100);
+    std::uniform_real_distribution<double> wiggle(-0.05, 0.05);
+
+    InterpolatedPath path;
+    const int waypoints = 120;
+    const RJ::Seconds duration = 3s;
+    for (int i = 0; i < waypoints; i++) {
+        const double s = double(i) / (waypoints - 1);
+        const Point pos(-2.5 + ahead + 5 * s, lane + wiggle(gen));
+        path.waypoints.emplace_back(MotionInstant(pos, Point(5 / 3.0, 0)),
+                                    duration * s);
+    }
+    path.setStartTime(startTime);
+    return path;
+}
+
+/// A path like the ones RRTPlanner makes from @segments Bezier segments, with
+/// the most waypoints it samples per segment (40) at uneven times
+InterpolatedPath bezierPath(int segments) {
+    std::mt19937 gen(segments);
+    std::uniform_real_distribution<double> step(0.01, 0.04);
+
+    InterpolatedPath path;
+    RJ::Seconds t = 0s;
+    for (int i = 0; i < segments * 40; i++) {
+        const Point pos(std::cos(t.count()), std::sin(t.count()));
+        path.waypoints.emplace_back(MotionInstant(pos, pos.perpCW()), t);
+        t += RJ::Seconds(step(gen));
+    }
+    return path;
+}
+
+}  // namespace
+
+TEST(PathBenchmark, evaluate) {
+    for (int segments : {1, 3, 10}) {
+        const InterpolatedPath path = bezierPath(segments);
+        const double duration = path.getDuration().count();
+
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double> time(0, duration);
+        std::vector<RJ::Seconds> times(1024);
+        for (RJ::Seconds& t : times) {
+            t = RJ::Seconds(time(gen));
+        }
+
+        // Stepping through the path 10ms at a time, starting over at the end
+        const int steps = duration / 0.01;
+        auto sweepTime = [&](int i) { return RJ::Seconds(0.01 * (i % steps)); };
+
+        const std::string waypoints =
+            std::to_string(path.waypoints.size()) + " waypoints";
+        Benchmark::report(
+            "evaluate, random times, " + waypoints,
+            Benchmark::nsPerIteration(100000, [&](int i) {
+                Benchmark::doNotOptimize(path.evaluate(times[i % 1024]));
+            }));
+        Benchmark::report("evaluate, sweep, " + waypoints,
+                          Benchmark::nsPerIteration(100000, [&](int i) {
+                              Benchmark::doNotOptimize(
+                                  path.evaluate(sweepTime(i)));
+                          }));
+        InterpolatedPath::Cursor cursor(path);
+        Benchmark::report("cursor, sweep, " + waypoints,
+                          Benchmark::nsPerIteration(100000, [&](int i) {
+                              Benchmark::doNotOptimize(
+                                  cursor.evaluate(sweepTime(i)));
+                          }));
+    }
+}
+
+TEST(PathBenchmark, pathsIntersect) {
+    const RJ::Time now = RJ::now();
+    const InterpolatedPath path = lanePath(0, now);
+
+    // Other robots in the same lane ahead of this one, so nothing hits but
+    // every check has to go through the whole path
+    for (int count : {1, 5, 11}) {
+        std::vector<InterpolatedPath> others;
+        others.reserve(count);
+        std::vector<DynamicObstacle> obstacles;
+        for (int i = 0; i < count; i++) {
+            others.push_back(lanePath(0.4 * (i + 1), now + 10ms * i));
+            obstacles.emplace_back(&others.back(), Robot_Radius);
+        }
+        ASSERT_FALSE(path.pathsIntersect(obstacles, now, nullptr, nullptr));
+        ASSERT_FALSE(
+            path.Path::pathsIntersect(obstacles, now, nullptr, nullptr));
+
+        const std::string robots = std::to_string(count) + " robots";
+        Benchmark::report(
+            "sampled, " + robots,
+            Benchmark::nsPerIteration(2000, [&](int i) {
+                Benchmark::doNotOptimize(path.Path::pathsIntersect(
+                    obstacles, now, nullptr, nullptr));
+            }));
+        Benchmark::report(
+            "analytic, " + robots,
+            Benchmark::nsPerIteration(2000, [&](int i) {
+                Benchmark::doNotOptimize(
+                    path.pathsIntersect(obstacles, now, nullptr, nullptr));
+            }));
+    }
+}
+
+TEST(PathBenchmark, spaceTimeGrid) {
+    const RJ::Time now = RJ::now();
+    const InterpolatedPath path = lanePath(0, now);
+
+    // Other robots spread out in their own lanes up the field, so most of
+    // them are never near this one
+    for (int count : {1, 5, 11}) {
+        std::vector<InterpolatedPath> others;
+        others.reserve(count);
+        std::vector<DynamicObstacle> obstacles;
+        for (int i = 0; i < count; i++) {
+            others.push_back(lanePath(0.4 * i, now, 1.6 + 0.6 * i));
+            obstacles.emplace_back(&others.back(), Robot_Radius);
+        }
+
+        SpaceTimeGrid grid;
+        auto build = [&]() {
+            grid.reset(now);
+            for (const DynamicObstacle& obs : obstacles) {
+                grid.add(obs);
+            }
+        };
+        build();
+        ASSERT_FALSE(path.pathsIntersect(obstacles, now, nullptr, nullptr));
+        ASSERT_FALSE(grid.pathsIntersect(path, now, nullptr, nullptr));
+
+        const std::string robots = std::to_string(count) + " robots";
+        Benchmark::report("build grid, " + robots,
+                          Benchmark::nsPerIteration(200, [&](int i) {
+                              build();
+                              Benchmark::doNotOptimize(grid);
+                          }));
+        Benchmark::report(
+            "sampled, " + robots,
+            Benchmark::nsPerIteration(2000, [&](int i) {
+                Benchmark::doNotOptimize(path.Path::pathsIntersect(
+                    obstacles, now, nullptr, nullptr));
+            }));
+        Benchmark::report(
+            "analytic, " + robots,
+            Benchmark::nsPerIteration(2000, [&](int i) {
+                Benchmark::doNotOptimize(
+                    path.pathsIntersect(obstacles, now, nullptr, nullptr));
+            }));
+        Benchmark::report(
+            "grid, " + robots,
+            Benchmark::nsPerIteration(2000, [&](int i) {
+                Benchmark::doNotOptimize(
+                    grid.pathsIntersect(path, now, nullptr, nullptr));
+            }));
+        Benchmark::report(
+            "grid point, " + robots,
+            Benchmark::nsPerIteration(2000, [&](int i) {
+                Benchmark::doNotOptimize(
+                    grid.hit(Point(-2.5 + 0.001 * i, 1), now + 1ms * i));
+            }));
+    }
+}
+
+}  // namespace Planning
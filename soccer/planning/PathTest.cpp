@@ -1,5 +1,7 @@
 #include <iostream>
+#include <random>
 #include <gtest/gtest.h>
+#include <Constants.hpp>
 #include <planning/InterpolatedPath.hpp>
 #include <planning/CompositePath.hpp>
 
@@ -178,4 +180,169 @@ TEST(CompositePath, CompositeSubPath) {
     }
 }
 
+namespace {
+
+/// A path moving at a constant velocity from @start, starting at @startTime
+InterpolatedPath straightPath(Point start, Point vel, RJ::Seconds duration,
+                              RJ::Time startTime) {
+    InterpolatedPath path;
+    path.waypoints.emplace_back(MotionInstant(start, vel), 0s);
+    path.waypoints.emplace_back(
+        MotionInstant(start + vel * duration.count(), vel), duration);
+    path.setStartTime(startTime);
+    return path;
+}
+
+/// A random walk with waypoints a few tens of milliseconds apart, like the
+/// paths RRTPlanner makes
+InterpolatedPath randomPath(std::mt19937& gen, RJ::Time startTime) {
+    std::uniform_real_distribution<double> pos(-1, 1);
+    std::uniform_real_distribution<double> vel(-3, 3);
+    std::uniform_real_distribution<double> dt(0.01, 0.08);
+
+    InterpolatedPath path;
+    Point p(pos(gen), pos(gen));
+    RJ::Seconds t = 0s;
+    for (int i = 0; i < 40; i++) {
+        const Point v(vel(gen), vel(gen));
+        path.waypoints.emplace_back(MotionInstant(p, v), t);
+        const RJ::Seconds step(dt(gen));
+        p += v * step.count();
+        t += step;
+    }
+    path.setStartTime(startTime);
+    return path;
+}
+
+}  // namespace
+
+TEST(InterpolatedPath, pathsIntersectBetweenSamples) {
+    const RJ::Time now = RJ::now();
+
+    // Two robots passing each other too fast for 50ms samples to catch
+    const InterpolatedPath path =
+        straightPath(Point(-1.5, 0), Point(3, 0), 1s, now);
+    const InterpolatedPath other =
+        straightPath(Point(1.65, 0.12), Point(-3, 0), 1s, now);
+    const std::vector<DynamicObstacle> obstacles{
+        DynamicObstacle(&other, Robot_Radius)};
+
+    EXPECT_FALSE(path.Path::pathsIntersect(obstacles, now, nullptr, nullptr));
+
+    Point hitLocation;
+    RJ::Seconds hitTime;
+    ASSERT_TRUE(path.pathsIntersect(obstacles, now, &hitLocation, &hitTime));
+
+    // They first touch when they're 2 * Robot_Radius apart
+    const double gap = std::sqrt(std::pow(2 * Robot_Radius, 2) - 0.12 * 0.12);
+    const double expectedTime = (3.15 - gap) / 6;
+    EXPECT_NEAR(expectedTime, hitTime.count(), 1e-6);
+    EXPECT_NEAR(1.65 - 3 * expectedTime, hitLocation.x(), 1e-6);
+    EXPECT_NEAR(0.12, hitLocation.y(), 1e-6);
+}
+
+TEST(InterpolatedPath, pathsIntersectMatchesSampled) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> offset(-0.3, 0.3);
+    const RJ::Time now = RJ::now();
+
+    int hits = 0;
+    for (int i = 0; i < 500; i++) {
+        const InterpolatedPath path = randomPath(gen, now);
+        const InterpolatedPath other =
+            randomPath(gen, now + RJ::Seconds(offset(gen)));
+        const std::vector<DynamicObstacle> obstacles{
+            DynamicObstacle(&other, Robot_Radius)};
+        const RJ::Time startTime = now + RJ::Seconds(offset(gen) + 0.3);
+
+        RJ::Seconds sampledTime;
+        const bool sampled = path.Path::pathsIntersect(
+            obstacles, startTime, nullptr, &sampledTime);
+        Point hitLocation;
+        RJ::Seconds hitTime;
+        const bool exact =
+            path.pathsIntersect(obstacles, startTime, &hitLocation, &hitTime);
+
+        // Anything a sample finds is found at or before the sample
+        if (sampled) {
+            ASSERT_TRUE(exact);
+            EXPECT_LE(hitTime.count(), sampledTime.count() + 1e-9);
+        }
+        if (exact) {
+            hits++;
+            // And the robots are touching at the time it finds
+            EXPECT_GE(hitTime.count(),
+                      RJ::Seconds(startTime - now).count() - 1e-9);
+            const Point pos = path.evaluate(hitTime)->motion.pos;
+            EXPECT_LE(pos.distTo(hitLocation), 2 * Robot_Radius + 1e-6);
+        }
+    }
+    // Both cases are covered
+    EXPECT_GT(hits, 50);
+    EXPECT_LT(hits, 450);
+}
+
+TEST(InterpolatedPath, evaluateAtWaypoints) {
+    InterpolatedPath path;
+    path.waypoints.emplace_back(MotionInstant(Point(0, 0), Point(1, 0)), 0s);
+    path.waypoints.emplace_back(MotionInstant(Point(1, 0), Point(1, 0)), 1s);
+    path.waypoints.emplace_back(MotionInstant(Point(1, 0), Point(0, 1)), 1s);
+    path.waypoints.emplace_back(MotionInstant(Point(1, 1), Point(0, 0)), 2s);
+
+    // At a waypoint's time, the first waypoint with that time
+    auto instant = path.evaluate(1s);
+    ASSERT_TRUE(instant);
+    EXPECT_EQ(Point(1, 0), instant->motion.vel);
+
+    instant = path.evaluate(1.5s);
+    ASSERT_TRUE(instant);
+    EXPECT_NEAR(1, instant->motion.pos.x(), 1e-6);
+    EXPECT_NEAR(0.5, instant->motion.pos.y(), 1e-6);
+
+    // The end is part of the path, but nothing after it is
+    instant = path.evaluate(2s);
+    ASSERT_TRUE(instant);
+    EXPECT_EQ(Point(1, 1), instant->motion.pos);
+    EXPECT_FALSE(path.evaluate(2.5s));
+}
+
+TEST(InterpolatedPath, cursorMatchesEvaluate) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> time(-0.5, 2.5);
+
+    for (bool slowed : {false, true}) {
+        InterpolatedPath path = randomPath(gen, RJ::now());
+        // Some waypoints at the same time
+        path.waypoints.insert(path.waypoints.begin() + 10, path.waypoints[10]);
+        path.waypoints[11].vel() = Point(0, 0);
+        if (slowed) {
+            path.slow(0.7);
+        }
+
+        auto expectSame = [&](RJ::Seconds t, InterpolatedPath::Cursor& cursor) {
+            auto expected = path.evaluate(t);
+            auto instant = cursor.evaluate(t);
+            ASSERT_EQ(bool(expected), bool(instant)) << t.count();
+            if (expected) {
+                EXPECT_EQ(expected->motion.pos, instant->motion.pos);
+                EXPECT_EQ(expected->motion.vel, instant->motion.vel);
+            }
+        };
+
+        // Forward through every waypoint's time and between them
+        InterpolatedPath::Cursor forward(path);
+        for (const auto& entry : path.waypoints) {
+            expectSame(entry.time, forward);
+            expectSame(entry.time + 1ms, forward);
+        }
+        expectSame(path.getSlowedDuration() + 1s, forward);
+
+        // And jumping around
+        InterpolatedPath::Cursor random(path);
+        for (int i = 0; i < 200; i++) {
+            expectSame(RJ::Seconds(time(gen)), random);
+        }
+    }
+}
+
 }  // namespace Planning
@@ -9,10 +9,13 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include "RobotConstraints.hpp"
 
 namespace Planning {
 
+class SpaceTimeGrid;
+
 /**
  * @brief Encapsulates information needed for planner to make a path
  *
@@ -32,7 +35,8 @@ struct PlanRequest {
           prevPath(std::move(prevPath)),
           obstacles(obs),
           dynamicObstacles(dObs),
-          shellID(shellID) {}
+          shellID(shellID),
+          priority(priority) {}
 
     SystemState& systemState; /**< Allows debug drawing, position info */
     MotionInstant start;      /**< Starting state of the robot */
@@ -44,5 +48,15 @@ struct PlanRequest {
     std::vector<DynamicObstacle> dynamicObstacles; /**< Dynamic obstacles */
     unsigned shellID; /**< Shell ID used for debug drawing */
     int8_t priority;  /**< Higher priority planned first */
+
+    /// If set, planners that support it keep improving the path until this
+    /// time, then return the best one they have
+    std::optional<RJ::Time> deadline;
+
+    /// If set, the paths planned so far this frame for our other robots.
+    /// Those are added to dynamicObstacles after any it already had, so a
+    /// planner can only check against the grid in place of its moving
+    /// obstacles if the grid holds as many of them.
+    const SpaceTimeGrid* dynamicGrid = nullptr;
 };
 }
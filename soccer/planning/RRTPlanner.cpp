@@ -12,28 +12,39 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Eigen/Dense>
 #include <algorithm>
 #include <iostream>
 
 using namespace std;
-using namespace Eigen;
 using namespace Geometry2d;
 
 namespace Planning {
 REGISTER_CONFIGURABLE(RRTPlanner);
 
 ConfigDouble* RRTPlanner::_partialReplanLeadTime;
+ConfigBool* RRTPlanner::_pathRepair;
 
 void RRTPlanner::createConfiguration(Configuration* cfg) {
     _partialReplanLeadTime = new ConfigDouble(
         cfg, "RRTPlanner/partialReplanLeadTime", 0.2, "partialReplanLeadTime");
+    _pathRepair = new ConfigBool(
+        cfg, "RRTPlanner/pathRepair", true,
+        "When a path hits an obstacle, try replanning only the blocked part "
+        "of it before replanning to the goal");
+}
+
+RJ::Seconds RRTPlanner::ReplanStats::timeSaved() const {
+    if (repairs == 0 || replans == 0) {
+        return RJ::Seconds::zero();
+    }
+    return (replanTime / replans - repairTime / repairs) * repairs;
 }
 
 RRTPlanner::RRTPlanner(int minIterations, int maxIterations)
     : _minIterations(minIterations),
       _maxIterations(maxIterations),
-      SingleRobotPathPlanner(true) {}
+      SingleRobotPathPlanner(true),
+      _random(std::random_device{}()) {}
 
 bool veeredOffPath(Point currentPos, const Path& path,
                    MotionConstraints motionConstraints) {
@@ -95,7 +106,12 @@ bool RRTPlanner::shouldReplan(const PlanRequest& planRequest,
         return true;
     }
 
-    if (prevPath->pathsIntersect(dynamicObs, RJ::now(), nullptr, nullptr)) {
+    const SpaceTimeGrid* grid = usableDynamicGrid(planRequest, dynamicObs);
+    const bool dynamicHit =
+        grid ? grid->pathsIntersect(*prevPath, RJ::now(), nullptr, nullptr)
+             : prevPath->pathsIntersect(dynamicObs, RJ::now(), nullptr,
+                                        nullptr);
+    if (dynamicHit) {
         if (debugOut) {
             *debugOut = "DynamicIntersect";
         }
@@ -107,7 +123,95 @@ bool RRTPlanner::shouldReplan(const PlanRequest& planRequest,
 
 const int maxContinue = 10;
 
+namespace {
+
+// How far apart to check a path for the end of a blocked span
+const RJ::Seconds repairStep = 50ms;
+
+// How far past the end of a blocked span a repair rejoins the old path, so
+// the new span doesn't have to end right at the edge of the obstacle
+const RJ::Seconds repairClearance = 150ms;
+
+// Whether @path's position at @timeIntoPath is in an obstacle.  @grid, if
+// there is one, holds @dynamicObs.
+bool blockedAt(const Path& path, RJ::Seconds timeIntoPath,
+               const ShapeSet& obstacles,
+               const vector<DynamicObstacle>& dynamicObs,
+               const SpaceTimeGrid* grid) {
+    std::optional<RobotInstant> instant = path.evaluate(timeIntoPath);
+    const Point pos = instant ? instant->motion.pos : path.end().motion.pos;
+    if (obstacles.hit(pos)) {
+        return true;
+    }
+
+    const RJ::Time time = path.startTime() + timeIntoPath;
+    if (grid) {
+        return grid->hit(pos, time);
+    }
+    for (const DynamicObstacle& obs : dynamicObs) {
+        if (!obs.hasPath()) {
+            if (obs.getStaticObstacle()->hit(pos)) {
+                return true;
+            }
+            continue;
+        }
+
+        const Path* obsPath = obs.getPath();
+        const RJ::Seconds timeIntoObsPath =
+            std::max<RJ::Seconds>(time - obsPath->startTime(), 0ms);
+        std::optional<RobotInstant> obsInstant =
+            obsPath->evaluate(timeIntoObsPath);
+        const Point obsPos =
+            obsInstant ? obsInstant->motion.pos : obsPath->end().motion.pos;
+        if (pos.distTo(obsPos) < obs.getRadius() + Robot_Radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Finds the first time at or after @blockedTime where @path is past the
+// obstacles and stays clear of them for the rest of the path.  @grid, if
+// there is one, holds @dynamicObs.
+std::optional<RJ::Seconds> rejoinTime(
+    const Path& path, RJ::Seconds blockedTime, const ShapeSet& obstacles,
+    const vector<DynamicObstacle>& dynamicObs, const SpaceTimeGrid* grid) {
+    const RJ::Seconds duration = path.getDuration();
+    RJ::Seconds t = blockedTime;
+    while (t < duration) {
+        while (t < duration &&
+               blockedAt(path, t, obstacles, dynamicObs, grid)) {
+            t += repairStep;
+        }
+        t += repairClearance;
+        if (t >= duration) {
+            break;
+        }
+        if (blockedAt(path, t, obstacles, dynamicObs, grid)) {
+            continue;
+        }
+
+        // The rest of the path may run into something else, in which case
+        // the blocked span goes past that too
+        RJ::Seconds hitTime;
+        const RJ::Time time = path.startTime() + t;
+        if (path.hit(obstacles, t, &hitTime) ||
+            (grid ? grid->pathsIntersect(path, time, nullptr, &hitTime)
+                  : path.pathsIntersect(dynamicObs, time, nullptr,
+                                        &hitTime))) {
+            t = std::max(hitTime, t + repairStep);
+            continue;
+        }
+        return t;
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
 std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
+    const RJ::Time planStart = RJ::now();
+    _deadline = planRequest.deadline;
     const MotionInstant& start = planRequest.start;
     const auto& motionConstraints = planRequest.constraints.mot;
     Geometry2d::ShapeSet& obstacles = planRequest.obstacles;
@@ -125,6 +229,8 @@ std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
     vector<DynamicObstacle> actualDynamic;
     splitDynamic(obstacles, actualDynamic, dynamicObstacles);
 
+    _dynamicGrid = usableDynamicGrid(planRequest, actualDynamic);
+
     // Simple case: no path
     if (start.pos == goal.pos) {
         auto path = make_unique<InterpolatedPath>();
@@ -153,16 +259,22 @@ std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
         replanState = FullReplan;
     }
 
+    // When the previous path is invalid, the time into it where it became
+    // invalid, and whether that's because it's blocked by an obstacle
+    RJ::Seconds invalidTime;
+    bool blocked = false;
+
     if (replanState == Reuse) {
         const auto timeIntoPrevPath = RJ::now() - prevPath->startTime();
 
-        RJ::Seconds invalidTime;
         if (prevPath->hit(obstacles, timeIntoPrevPath, &invalidTime)) {
             replanState = PartialReplan;
+            blocked = true;
             debugOut = "hitObstacle";
-        } else if (prevPath->pathsIntersect(actualDynamic, RJ::now(), nullptr,
-                                            &invalidTime)) {
+        } else if (pathsIntersect(*prevPath, actualDynamic, RJ::now(),
+                                  nullptr, &invalidTime)) {
             replanState = PartialReplan;
+            blocked = true;
             debugOut = "pathsIntersect";
         } else if (goalChanged(goal, *prevPath)) {
             invalidTime = prevPath->getDuration();
@@ -179,6 +291,15 @@ std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
         }
     }
 
+    // Only paths that had to be replaced count toward the replan stats, not
+    // first plans or better paths found while the old one was still fine
+    auto recordReplan = [&]() {
+        if (prevPath) {
+            _replanStats.replans++;
+            _replanStats.replanTime += RJ::now() - planStart;
+        }
+    };
+
     std::unique_ptr<Path> path;
 
     if (replanState == Reuse) {
@@ -193,6 +314,21 @@ std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
         reusePathTries++;
     }
 
+    if (replanState == PartialReplan && blocked && *_pathRepair) {
+        const auto timeIntoPrevPath = RJ::now() - prevPath->startTime();
+        path = repairPath(*prevPath, timeIntoPrevPath + partialReplanTime,
+                          invalidTime, motionConstraints, obstacles,
+                          actualDynamic, &planRequest.systemState,
+                          planRequest.shellID);
+        if (path) {
+            path->setDebugText(QString::fromStdString("repair." + debugOut));
+            _replanStats.repairs++;
+            _replanStats.repairTime += RJ::now() - planStart;
+            return path;
+        }
+        debugOut += " Repair failed";
+    }
+
     if (replanState == CheckBetter || replanState == PartialReplan) {
         const auto timeIntoPrevPath = RJ::now() - prevPath->startTime();
         auto subPath =
@@ -240,6 +376,7 @@ std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
                     replanState = Reuse;
                 }
             } else {
+                recordReplan();
                 return path;
             }
         } else if (replanState == PartialReplan) {
@@ -264,6 +401,7 @@ std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
         } else {
             path = InterpolatedPath::emptyPath(start.pos);
         }
+        recordReplan();
         return path;
     } else {
         string type = [](auto replanState) {
@@ -285,6 +423,72 @@ std::unique_ptr<Path> RRTPlanner::run(PlanRequest& planRequest) {
     }
 }
 
+std::unique_ptr<Path> RRTPlanner::repairPath(
+    const Path& prevPath, RJ::Seconds repairStart, RJ::Seconds invalidTime,
+    const MotionConstraints& motionConstraints, ShapeSet& obstacles,
+    const vector<DynamicObstacle>& dynamicObs, SystemState* state,
+    unsigned shellID) {
+    const std::optional<RJ::Seconds> rejoin =
+        rejoinTime(prevPath, std::max(invalidTime, repairStart), obstacles,
+                   dynamicObs, _dynamicGrid);
+    if (!rejoin) {
+        return nullptr;
+    }
+
+    auto prefix = prevPath.subPath(0ms, repairStart);
+    auto suffix = prevPath.subPath(*rejoin);
+
+    // Bias the RRT toward the old path through the blocked span, so it mostly
+    // has to find its way around the obstacle
+    vector<Point> biasWaypoints;
+    for (RJ::Seconds t = repairStart; t < *rejoin; t += repairStep * 2) {
+        if (auto instant = prevPath.evaluate(t)) {
+            biasWaypoints.push_back(instant->motion.pos);
+        }
+    }
+
+    auto span =
+        generateRRTPath(prefix->end().motion, suffix->start().motion,
+                        motionConstraints, obstacles, dynamicObs, state,
+                        shellID, biasWaypoints);
+    if (!span) {
+        return nullptr;
+    }
+
+    auto path = make_unique<CompositePath>(std::move(prefix), std::move(span),
+                                           std::move(suffix));
+    path->setStartTime(prevPath.startTime());
+
+    // The new span changes when the robot gets to the rest of the old path,
+    // which can put it in the way of other robots' paths
+    if (pathsIntersect(*path, dynamicObs, RJ::now(), nullptr, nullptr)) {
+        return nullptr;
+    }
+    return std::move(path);
+}
+
+const SpaceTimeGrid* RRTPlanner::usableDynamicGrid(
+    const PlanRequest& planRequest, const vector<DynamicObstacle>& dynamicObs) {
+    // The grid can only stand in for the moving obstacles if it has all of
+    // them
+    const SpaceTimeGrid* grid = planRequest.dynamicGrid;
+    if (grid && grid->obstacles().size() != dynamicObs.size()) {
+        return nullptr;
+    }
+    return grid;
+}
+
+bool RRTPlanner::pathsIntersect(const Path& path,
+                                const vector<DynamicObstacle>& dynamicObs,
+                                RJ::Time startTime, Point* hitLocation,
+                                RJ::Seconds* hitTime) const {
+    if (_dynamicGrid) {
+        return _dynamicGrid->pathsIntersect(path, startTime, hitLocation,
+                                            hitTime);
+    }
+    return path.pathsIntersect(dynamicObs, startTime, hitLocation, hitTime);
+}
+
 std::unique_ptr<InterpolatedPath> RRTPlanner::generateRRTPath(
     const MotionInstant& start, const MotionInstant& goal,
     const MotionConstraints& motionConstraints, ShapeSet& origional,
@@ -293,6 +497,7 @@ std::unique_ptr<InterpolatedPath> RRTPlanner::generateRRTPath(
     const int tries = 10;
     ShapeSet obstacles = origional;
     unique_ptr<InterpolatedPath> lastPath;
+    unique_ptr<InterpolatedPath> bestPath;
     for (int i = 0; i < tries; i++) {
         // Run bi-directional RRT to generate a path.
         auto points = runRRT(start, goal, motionConstraints, obstacles, state,
@@ -313,17 +518,40 @@ std::unique_ptr<InterpolatedPath> RRTPlanner::generateRRTPath(
             break;
         }
 
+        // A new path is an InterpolatedPath, whose exact check skips
+        // obstacles that don't come near it faster than sampling the grid
         RJ::Seconds hitTime;
         Point hitLocation;
         bool hit = path->pathsIntersect(dyObs, path->startTime(), &hitLocation,
                                         &hitTime);
+
+        // The curve through the RRT's points can cut a corner into an
+        // obstacle the RRT went around, mostly when it has to end at speed
+        // like a repaired span does
+        if (!hit && path->hit(origional, 0ms, &hitTime)) {
+            hitLocation = path->evaluate(hitTime)->motion.pos;
+            hit = true;
+        }
         if (hit) {
             obstacles.add(
                 make_shared<Circle>(hitLocation, Robot_Radius * 1.5f));
             lastPath = std::move(path);
-        } else {
-            return std::move(path);
+            continue;
         }
+
+        if (!bestPath || path->getDuration() < bestPath->getDuration()) {
+            bestPath = std::move(path);
+        }
+
+        // With a deadline, keep trying for a faster path until then.  Each
+        // try's RRT only takes its share of the time that's left.  A
+        // straight path can't be beaten.
+        if (!_deadline || points.size() == 2 || RJ::now() >= *_deadline) {
+            break;
+        }
+    }
+    if (bestPath) {
+        return bestPath;
     }
     // debugLog("Generate Failed 10 times");
     return lastPath;
@@ -349,54 +577,120 @@ vector<Point> RRTPlanner::runRRTHelper(
     const MotionConstraints& motionConstraints, const ShapeSet& obstacles,
     SystemState* state, unsigned shellID,
     const std::optional<vector<Point>>& biasWaypoints, bool straightLine) {
-    // Initialize bi-directional RRT
-
-    auto stateSpace = make_shared<RoboCupStateSpace>(
-        Field_Dimensions::Current_Dimensions, obstacles);
-    RRT::BiRRT<Point> biRRT(stateSpace, Point::hash, 2);
+    // Initialize bi-directional RRT.  The trees are kept between plans, so
+    // this only allocates when they need to grow past their largest size yet.
+    RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                 obstacles);
     reusePathTries++;
-    biRRT.setStartState(start.pos);
-    biRRT.setGoalState(goal.pos);
+    _biRRT.setStartState(start.pos);
+    _biRRT.setGoalState(goal.pos);
+    _biRRT.clearWaypoints();
+    _biRRT.setWaypointBias(0);
+    _biRRT.setUseGrid(*RRTConfig::NearestNeighborGrid);
 
     // If trying to plan a straight path, plan a straight path. Otherwise, run
     // normal RRT.
     if (straightLine) {
         // Set the step size to be the distance between the start and goal.
-        biRRT.setStepSize(stateSpace->distance(start.pos, goal.pos));
+        _biRRT.setStepSize(stateSpace.distance(start.pos, goal.pos));
         // Plan straight toward the goal.
-        biRRT.setGoalBias(1);
+        _biRRT.setGoalBias(1);
         // Try up to five times. If unsuccessful after five tries, there
         // probably doesn't exist
         // a straight path.
-        biRRT.setMinIterations(0);
-        biRRT.setMaxIterations(5);
+        _biRRT.setMinIterations(0);
+        _biRRT.setMaxIterations(5);
+        _biRRT.setDeadline(std::nullopt);
     } else {
-        biRRT.setStepSize(*RRTConfig::StepSize);
-        biRRT.setMinIterations(_minIterations);
-        biRRT.setMaxIterations(_maxIterations);
-        biRRT.setGoalBias(*RRTConfig::GoalBias);
+        _biRRT.setStepSize(*RRTConfig::StepSize);
+        _biRRT.setMinIterations(_minIterations);
+        _biRRT.setMaxIterations(
+            _deadline
+                ? std::max(_maxIterations,
+                           RRTConfig::AnytimeMaxIterations->value())
+                : _maxIterations);
+        _biRRT.setGoalBias(*RRTConfig::GoalBias);
 
         if (biasWaypoints) {
-            biRRT.setWaypoints(*biasWaypoints);
-            biRRT.setWaypointBias(*RRTConfig::WaypointBias);
+            _biRRT.setWaypoints(*biasWaypoints);
+            _biRRT.setWaypointBias(*RRTConfig::WaypointBias);
         }
+
+        // Leave the rest of the time for shortcutting and other tries
+        std::optional<RJ::Time> rrtDeadline;
+        if (_deadline) {
+            const RJ::Time now = RJ::now();
+            const RJ::Seconds left =
+                std::max(RJ::Seconds(*_deadline - now), RJ::Seconds::zero());
+            rrtDeadline = now + left * *RRTConfig::AnytimeRRTFraction;
+        }
+        _biRRT.setDeadline(rrtDeadline);
     }
 
-    bool success = biRRT.run();
+    bool success = _biRRT.run(stateSpace);
     if (!success) return vector<Point>();
 
     if (*RRTConfig::EnableRRTDebugDrawing) {
-        DrawBiRRT(biRRT, state, shellID);
+        DrawBiRRT(_biRRT, state, shellID);
     }
 
-    vector<Point> points = biRRT.getPath();
+    vector<Point> points = _biRRT.getPath();
 
     // Optimize out uneccesary waypoints
-    RRT::SmoothPath(points, *stateSpace);
+    RRT::SmoothPath(points, stateSpace);
+    if (_deadline) {
+        shortcutPath(points, stateSpace, *_deadline);
+    }
 
     return points;
 }
 
+void RRTPlanner::shortcutPath(vector<Point>& path,
+                              const RoboCupStateSpace& stateSpace,
+                              RJ::Time deadline) {
+    // Give up after this many shortcuts in a row that weren't valid, since
+    // the path is probably as short as it's going to get
+    const int maxFailures = 50;
+
+    // Shortcuts have to save at least this much distance, so the path doesn't
+    // gain points for shortcuts that barely help
+    const double minSaving = 0.01;
+
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int failures = 0;
+         failures < maxFailures && path.size() > 2 && RJ::now() < deadline;
+         failures++) {
+        // Pick points on two different segments and try to go straight from
+        // one to the other
+        std::uniform_int_distribution<int> segment(0, path.size() - 2);
+        int i = segment(_random);
+        int j = segment(_random);
+        if (i == j) {
+            continue;
+        }
+        if (i > j) {
+            std::swap(i, j);
+        }
+
+        const Point a = path[i] + (path[i + 1] - path[i]) * unit(_random);
+        const Point b = path[j] + (path[j + 1] - path[j]) * unit(_random);
+
+        double length = a.distTo(path[i + 1]) + path[j].distTo(b);
+        for (int k = i + 1; k < j; k++) {
+            length += path[k].distTo(path[k + 1]);
+        }
+        if (length - a.distTo(b) < minSaving ||
+            !stateSpace.transitionValid(a, b)) {
+            continue;
+        }
+
+        // Points i + 1 ... j are replaced by a and b
+        path.erase(path.begin() + i + 1, path.begin() + j + 1);
+        path.insert(path.begin() + i + 1, {a, b});
+        failures = -1;
+    }
+}
+
 double getTime(vector<Point> path, int index,
                const MotionConstraints& motionConstraints, double startSpeed,
                double endSpeed) {
@@ -476,15 +770,12 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
     Geometry2d::Point vf, const std::optional<vector<double>>& times) {
     size_t length = points.size();
     size_t curvesNum = length - 1;
-    vector<double> pointsX(length);
-    vector<double> pointsY(length);
-    vector<double> ks(length - 1);
-    vector<double> ks2(length - 1);
 
-    for (int i = 0; i < length; i++) {
-        pointsX[i] = points[i].x();
-        pointsY[i] = points[i].y();
-    }
+    // Kept between calls so replanning doesn't allocate them every time
+    thread_local vector<double> ks;
+    thread_local vector<Point> velocities;
+    ks.resize(curvesNum);
+
     const double startSpeed = vi.mag();
 
     const double endSpeed = vf.mag();
@@ -493,7 +784,6 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
         assert(times->size() == points.size());
         for (int i = 0; i < curvesNum; i++) {
             ks[i] = 1.0 / (times->at(i + 1) - times->at(i));
-            ks2[i] = ks[i] * ks[i];
             if (std::isnan(ks[i])) {
                 debugThrow(
                     "Something went wrong. Points are too close to each other "
@@ -507,7 +797,6 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
                                    endSpeed) -
                            getTime(points, i, motionConstraints, startSpeed,
                                    endSpeed));
-            ks2[i] = ks[i] * ks[i];
             if (std::isnan(ks[i])) {
                 debugThrow(
                     "Something went wrong. Points are too close to each other "
@@ -517,22 +806,22 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
         }
     }
 
-    VectorXd solutionX =
-        RRTPlanner::cubicBezierCalc(vi.x(), vf.x(), pointsX, ks, ks2);
-    VectorXd solutionY =
-        RRTPlanner::cubicBezierCalc(vi.y(), vf.y(), pointsY, ks, ks2);
-
-    if (solutionX.hasNaN() || solutionY.hasNaN()) {
-        return vector<CubicBezierControlPoints>();
-    }
+    RRTPlanner::cubicBezierCalc(vi, vf, points, ks, velocities);
 
     vector<CubicBezierControlPoints> path;
+    path.reserve(curvesNum);
 
     for (int i = 0; i < curvesNum; i++) {
+        // Each curve's velocity is 3 * ks[i] * (p1 - p0) at its start and
+        // 3 * ks[i] * (p3 - p2) at its end
         Point p0 = points[i];
-        Point p1 = Point(solutionX(i * 2), solutionY(i * 2));
-        Point p2 = Point(solutionX(i * 2 + 1), solutionY(i * 2 + 1));
+        Point p1 = points[i] + velocities[i] / (3 * ks[i]);
+        Point p2 = points[i + 1] - velocities[i + 1] / (3 * ks[i]);
         Point p3 = points[i + 1];
+        if (std::isnan(p1.x()) || std::isnan(p1.y()) || std::isnan(p2.x()) ||
+            std::isnan(p2.y())) {
+            return vector<CubicBezierControlPoints>();
+        }
         path.emplace_back(p0, p1, p2, p3);
     }
     return path;
@@ -569,6 +858,54 @@ double oneStepLimitAcceleration(double maxAceleration, double d1, double v1,
     return std::min(v2, maxSpeed);
 }
 
+namespace {
+
+// How far a straight line between samples of a Bezier curve can be from the
+// curve itself, in meters
+constexpr double bezierSampleTolerance = 0.005;
+
+// The most a Bezier curve is sampled per meter and the most its direction
+// turns between samples, so the velocity profile sees where the robot speeds
+// up, slows down and turns
+constexpr double bezierSampleSpacing = 0.05;
+constexpr double bezierSampleTurn = 0.1;
+
+// Number of samples to take of @curve, from 2 to @maxSamples, so that short
+// and straight curves get fewer samples than long and curvy ones
+int bezierSamples(const CubicBezierControlPoints& curve, int maxSamples) {
+    const Point legs[] = {curve.p1 - curve.p0, curve.p2 - curve.p1,
+                          curve.p3 - curve.p2};
+
+    // The curve is no longer than its control polygon and turns no more than
+    // it does.  Legs shorter than the tolerance can point anywhere, like the
+    // first one of a curve that starts at rest, so they don't count as turns.
+    double length = 0;
+    double turn = 0;
+    const Point* lastLeg = nullptr;
+    for (const Point& leg : legs) {
+        length += leg.mag();
+        if (leg.mag() < bezierSampleTolerance) {
+            continue;
+        }
+        if (lastLeg) {
+            turn += lastLeg->angleBetween(leg);
+        }
+        lastLeg = &leg;
+    }
+
+    // With n evenly spaced samples in t, a chord is at most |B''| / (8 n^2)
+    // from the curve, and |B''| is at most 6 times the larger of the control
+    // polygon's second differences
+    const double secondDiff = std::max((legs[1] - legs[0]).mag(),
+                                       (legs[2] - legs[1]).mag());
+    const double samples =
+        std::max({length / bezierSampleSpacing, turn / bezierSampleTurn,
+                  std::sqrt(3 * secondDiff / (4 * bezierSampleTolerance))});
+    return std::min(std::max(int(std::ceil(samples)), 2), maxSamples);
+}
+
+}  // namespace
+
 /**
  * Generates a Cubic Bezier Path based on Albert's random Bezier Velocity Path
  * Algorithm
@@ -591,8 +928,9 @@ std::vector<InterpolatedPath::Entry> RRTPlanner::generateVelocityPath(
         Point p1 = controlPoint.p1;
         Point p2 = controlPoint.p2;
         Point p3 = controlPoint.p3;
-        for (int j = 0; j < interpolations; j++) {
-            double t = (((double)j / (double)(interpolations)));
+        const int samples = bezierSamples(controlPoint, interpolations);
+        for (int j = 0; j < samples; j++) {
+            double t = (((double)j / (double)(samples)));
             Geometry2d::Point pos =
                 pow(1.0 - t, 3) * p0 + 3.0 * pow(1.0 - t, 2) * t * p1 +
                 3 * (1.0 - t) * pow(t, 2) * p2 + pow(t, 3) * p3;
@@ -760,45 +1098,49 @@ std::unique_ptr<Planning::InterpolatedPath> RRTPlanner::generateCubicBezier(
     return path;
 }
 
-VectorXd RRTPlanner::cubicBezierCalc(double vi, double vf,
-                                     vector<double>& points, vector<double>& ks,
-                                     vector<double>& ks2) {
-    int curvesNum = points.size() - 1;
+void RRTPlanner::cubicBezierCalc(Point vi, Point vf,
+                                 const vector<Point>& points,
+                                 const vector<double>& ks,
+                                 vector<Point>& velocities) {
+    const int curvesNum = points.size() - 1;
+    velocities.resize(curvesNum + 1);
+    velocities[0] = vi;
+    velocities[curvesNum] = vf;
+
+    // Matching the accelerations where curves n and n + 1 meet at point
+    // j = n + 1 gives
+    //   ks[n] v[j-1] + 2 (ks[n] + ks[n+1]) v[j] + ks[n+1] v[j+1] =
+    //       3 (ks[n+1]^2 (p[j+1] - p[j]) + ks[n]^2 (p[j] - p[j-1]))
+    // for each of the inner points.  That's a tridiagonal system, and it's
+    // diagonally dominant, so it's solved by elimination without pivoting
+    // (the Thomas algorithm).  The forward pass leaves the eliminated
+    // right-hand side in velocities and the eliminated upper diagonal in
+    // upper.
+    thread_local vector<double> upper;
+    upper.resize(curvesNum + 1);
+    for (int j = 1; j < curvesNum; j++) {
+        const double k0 = ks[j - 1];
+        const double k1 = ks[j];
+        Point rhs = 3 * (k1 * k1 * (points[j + 1] - points[j]) +
+                         k0 * k0 * (points[j] - points[j - 1]));
+        double diagonal = 2 * (k0 + k1);
+        if (j == 1) {
+            rhs -= k0 * vi;
+        } else {
+            diagonal -= k0 * upper[j - 1];
+            rhs -= k0 * velocities[j - 1];
+        }
+        if (j == curvesNum - 1) {
+            rhs -= k1 * vf;
+            upper[j] = 0;
+        } else {
+            upper[j] = k1 / diagonal;
+        }
+        velocities[j] = rhs / diagonal;
+    }
 
-    if (curvesNum == 1) {
-        VectorXd vector(2);
-        vector[0] = vi / (3.0 * ks[0]) + points[0];
-        vector[1] = points[curvesNum] - vf / (3 * ks[curvesNum - 1]);
-        return vector;
-    } else {
-        int matrixSize = curvesNum * 2;
-        MatrixXd equations = MatrixXd::Zero(matrixSize, matrixSize);
-        VectorXd answer(matrixSize);
-        equations(0, 0) = 1;
-        answer(0) = vi / (3.0 * ks[0]) + points[0];
-        equations(1, matrixSize - 1) = 1;
-        answer(1) = points[curvesNum] - vf / (3 * ks[curvesNum - 1]);
-
-        int i = 2;
-        for (int n = 0; n < curvesNum - 1; n++) {
-            equations(i, n * 2 + 1) = ks[n];
-            equations(i, n * 2 + 2) = ks[n + 1];
-            answer(i) = (ks[n] + ks[n + 1]) * points[n + 1];
-            i++;
-        }
-
-        for (int n = 0; n < curvesNum - 1; n++) {
-            equations(i, n * 2) = ks2[n];
-            equations(i, n * 2 + 1) = -2 * ks2[n];
-            equations(i, n * 2 + 2) = 2 * ks2[n + 1];
-            equations(i, n * 2 + 3) = -ks2[n + 1];
-            answer(i) = points[n + 1] * (ks2[n + 1] - ks2[n]);
-            i++;
-        }
-
-        HouseholderQR<MatrixXd> solver(equations);
-        VectorXd solution = solver.solve(answer);
-        return solution;
+    for (int j = curvesNum - 2; j >= 1; j--) {
+        velocities[j] -= upper[j] * velocities[j + 1];
     }
 }
 
@@ -10,12 +10,13 @@
 #include <planning/MotionInstant.hpp>
 #include "SingleRobotPathPlanner.hpp"
 
-#include <rrt/BiRRT.hpp>
+#include "RRTTree.hpp"
+#include "SpaceTimeGrid.hpp"
 
 #include "SystemState.hpp"
 
-#include <Eigen/Dense>
 #include <list>
+#include <random>
 
 namespace Planning {
 
@@ -35,6 +36,20 @@ struct CubicBezierControlPoints {
  * [RRTs](http://en.wikipedia.org/wiki/Rapidly-exploring_random_tree).
  * You can check out our interactive RRT applet on GitHub here:
  * https://github.com/RoboJackets/rrt.
+ *
+ * When the previous path runs into an obstacle, the planner first tries to
+ * repair it: the part of the path before the obstacle and the part after it
+ * are kept, and an RRT is only run between them.  If that doesn't work, it
+ * replans to the goal.
+ *
+ * If the PlanRequest has a deadline, the planner works until then to improve
+ * the paths it plans.  Each RRT keeps looking for a shorter path for its share
+ * of the time left (RRTConfig::AnytimeRRTFraction), and then its path is
+ * shortcut.  With the rest, more RRTs are run and the fastest of the curves
+ * fit to them is kept.
+ *
+ * If it has a dynamic grid, the previous path is checked against that instead
+ * of against every other robot's path.
  */
 class RRTPlanner : public SingleRobotPathPlanner {
 public:
@@ -78,20 +93,66 @@ public:
 
     static RJ::Seconds getPartialReplanLeadTime();
 
+    /// How this planner has replaced paths that became invalid, for logging
+    struct ReplanStats {
+        /// Paths fixed by replanning only their blocked span
+        int repairs = 0;
+
+        /// Paths replaced by an RRT to the goal
+        int replans = 0;
+
+        /// Total planning time spent on each
+        RJ::Seconds repairTime{0};
+        RJ::Seconds replanTime{0};
+
+        /// Estimated planning time saved by repairing paths instead of
+        /// replanning them, based on the average time of each
+        RJ::Seconds timeSaved() const;
+    };
+
+    const ReplanStats& replanStats() const { return _replanStats; }
+
 private:
     int reusePathTries = 0;
 
+    ReplanStats _replanStats;
+
+    /// Reused for every plan so its trees don't have to be reallocated
+    BiRRT _biRRT;
+
+    /// Deadline of the plan request being run, if it has one
+    std::optional<RJ::Time> _deadline;
+
+    /// Dynamic grid of the plan request being run, if it has one
+    const SpaceTimeGrid* _dynamicGrid = nullptr;
+
+    std::mt19937 _random;
+
 protected:
     /// minimum and maximum number of rrt iterations to run
     /// this does not include connect attempts
     int _minIterations, _maxIterations;
 
     /// Check to see if the previous path (if any) should be discarded and
-    /// replaced with a newly-planned one
+    /// replaced with a newly-planned one.  @dynamicObs are the moving
+    /// obstacles.  They're checked through the request's dynamic grid if it
+    /// holds all of them.
     bool shouldReplan(const PlanRequest& planRequest,
                       const std::vector<DynamicObstacle> dynamicObs,
                       std::string* debugOut = nullptr) const;
 
+    /// The request's dynamic grid if it holds all of @dynamicObs, or nullptr
+    static const SpaceTimeGrid* usableDynamicGrid(
+        const PlanRequest& planRequest,
+        const std::vector<DynamicObstacle>& dynamicObs);
+
+    /// Path::pathsIntersect(), using the dynamic grid if there is one.
+    /// @dynamicObs must be the obstacles in the grid.
+    bool pathsIntersect(const Path& path,
+                        const std::vector<DynamicObstacle>& dynamicObs,
+                        RJ::Time startTime, Geometry2d::Point* hitLocation,
+                        RJ::Seconds* hitTime) const;
+
     /// Runs a bi-directional RRT to attempt to join the start and end states.
     std::vector<Geometry2d::Point> runRRT(
         MotionInstant start, MotionInstant goal,
@@ -101,6 +162,21 @@ protected:
         const std::optional<std::vector<Geometry2d::Point>>& biasWaypoints =
             std::nullopt);
 
+    /**
+     * Replaces the span of @prevPath that's blocked at @invalidTime with a new
+     * RRT path, keeping the path up to @repairStart and the path after the
+     * blocked span.
+     *
+     * @return the repaired path, or nullptr if the rest of the path is blocked
+     *     too or no path around the blocked span was found
+     */
+    std::unique_ptr<Path> repairPath(
+        const Path& prevPath, RJ::Seconds repairStart, RJ::Seconds invalidTime,
+        const MotionConstraints& motionConstraints,
+        Geometry2d::ShapeSet& obstacles,
+        const std::vector<DynamicObstacle>& dynamicObs, SystemState* state,
+        unsigned shellID);
+
     std::unique_ptr<InterpolatedPath> generateRRTPath(
         const MotionInstant& start, const MotionInstant& goal,
         const MotionConstraints& motionConstraints,
@@ -125,6 +201,14 @@ protected:
         const MotionConstraints& motionConstraints, Geometry2d::Point vi,
         Geometry2d::Point vf);
 
+    /**
+     * Shortens @path by joining random points on it with straight lines that
+     * are valid in @stateSpace, until @deadline or until it stops finding
+     * shortcuts
+     */
+    void shortcutPath(std::vector<Geometry2d::Point>& path,
+                      const RoboCupStateSpace& stateSpace, RJ::Time deadline);
+
     /**
      *  Removes unnecesary waypoints in the path
      */
@@ -146,7 +230,8 @@ protected:
 
     /**
      * Generates a velocity profile from a Cubic Bezier Path under the given
-     * motion constratins
+     * motion constratins.  Each curve is sampled at up to @interpolations
+     * points, with fewer for curves that are short or nearly straight.
      */
     static std::vector<InterpolatedPath::Entry> generateVelocityPath(
         const std::vector<CubicBezierControlPoints>& controlPoints,
@@ -163,14 +248,18 @@ protected:
         Geometry2d::Point vf);
 
     /**
-     * Helper function for cubicBezier() which uses Eigen matrices to solve for
-     * the
-     * cubic bezier equations.
+     * Helper function for generateCubicBezierPath() which finds the velocity
+     * at each of @points for the curves through them to have matching
+     * velocities and accelerations where they meet.  @ks[i] is 1 / the
+     * duration of the curve from @points[i] to @points[i+1].
+     *
+     * The equations are tridiagonal, so this takes linear time and solves for
+     * x and y together.
      */
-    static Eigen::VectorXd cubicBezierCalc(double vi, double vf,
-                                           std::vector<double>& points,
-                                           std::vector<double>& ks,
-                                           std::vector<double>& ks2);
+    static void cubicBezierCalc(Geometry2d::Point vi, Geometry2d::Point vf,
+                                const std::vector<Geometry2d::Point>& points,
+                                const std::vector<double>& ks,
+                                std::vector<Geometry2d::Point>& velocities);
 
     /**
  * Helper method for runRRT(), which creates a vector of points representing
@@ -185,5 +274,6 @@ protected:
         bool straightLine);
 
     static ConfigDouble* _partialReplanLeadTime;
+    static ConfigBool* _pathRepair;
 };
 }  // namespace Planning
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <Benchmark.hpp>
+#include <planning/DenseBezierSolve.hpp>
+#include <planning/RRTPlanner.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Geometry2d;
+
+namespace Planning {
+
+namespace {
+
+/// Sets of @count points winding across the field, like the ones RRT gives
+/// after shortcutting
+std::vector<std::vector<Point>> windingPoints(int count) {
+    std::mt19937 gen(count);
+    std::uniform_real_distribution<double> turn(-1.2, 1.2);
+    std::uniform_real_distribution<double> length(0.2, 1.2);
+
+    std::vector<std::vector<Point>> paths(50);
+    for (std::vector<Point>& points : paths) {
+        points.emplace_back(0, 1);
+        double angle = 0;
+        for (int i = 1; i < count; i++) {
+            angle += turn(gen);
+            points.push_back(points.back() +
+                             Point::direction(angle) * length(gen));
+        }
+    }
+    return paths;
+}
+
+void cubicBezierCalc(int count) {
+    const std::vector<std::vector<Point>> paths = windingPoints(count);
+
+    // Curves taken at a steady 1.5 m/s
+    std::vector<std::vector<double>> ks;
+    for (const std::vector<Point>& points : paths) {
+        ks.emplace_back();
+        for (int i = 0; i + 1 < points.size(); i++) {
+            ks.back().push_back(1.5 / points[i].distTo(points[i + 1]));
+        }
+    }
+
+    const std::string suffix = " " + std::to_string(count) + " points";
+    std::vector<Point> velocities;
+    Benchmark::report("RRTPlanner::cubicBezierCalc" + suffix,
+                      Benchmark::nsPerIteration(20000, [&](int i) {
+                          const int n = i % paths.size();
+                          BezierPlanner::cubicBezierCalc(
+                              Point(), Point(), paths[n], ks[n], velocities);
+                          Benchmark::doNotOptimize(velocities);
+                      }));
+    Benchmark::report("dense QR solve (before)" + suffix,
+                      Benchmark::nsPerIteration(20000, [&](int i) {
+                          const int n = i % paths.size();
+                          Benchmark::doNotOptimize(denseBezierVelocities(
+                              Point(), Point(), paths[n], ks[n]));
+                      }));
+}
+
+void generatePath(int count) {
+    const std::vector<std::vector<Point>> paths = windingPoints(count);
+    const ShapeSet obstacles;
+    const MotionConstraints motionConstraints;
+
+    size_t waypoints = 0;
+    for (const std::vector<Point>& points : paths) {
+        waypoints += RRTPlanner::generatePath(points, obstacles,
+                                              motionConstraints, Point(),
+                                              Point())
+                         ->waypoints.size();
+    }
+
+    const std::string name =
+        "RRTPlanner::generatePath " + std::to_string(count) + " points";
+    Benchmark::report(name, Benchmark::nsPerIteration(500, [&](int i) {
+                          Benchmark::doNotOptimize(RRTPlanner::generatePath(
+                              paths[i % paths.size()], obstacles,
+                              motionConstraints, Point(), Point()));
+                      }));
+    printf("[ BENCH    ] %-48s %12.1f waypoints\n", name.c_str(),
+           double(waypoints) / paths.size());
+}
+
+}  // namespace
+
+TEST(RRTPlannerBenchmark, cubicBezierCalc) {
+    cubicBezierCalc(5);
+    cubicBezierCalc(10);
+    cubicBezierCalc(15);
+}
+
+TEST(RRTPlannerBenchmark, generatePath) {
+    generatePath(5);
+    generatePath(10);
+    generatePath(15);
+}
+
+}  // namespace Planning
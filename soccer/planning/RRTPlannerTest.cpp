@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/Point.hpp>
+#include "DenseBezierSolve.hpp"
+#include "RRTPlanner.hpp"
+#include "RoboCupStateSpace.hpp"
+#include "planning/MotionCommand.hpp"
+
+#include <random>
+
+using namespace Geometry2d;
+
+namespace Planning {
+
+namespace {
+
+/// Gives the tests access to RRTPlanner's path shortcutting
+class ShortcutPlanner : public RRTPlanner {
+public:
+    ShortcutPlanner() : RRTPlanner(100, 250) {}
+
+    using RRTPlanner::shortcutPath;
+};
+
+double pathLength(const std::vector<Point>& path) {
+    double length = 0;
+    for (int i = 0; i + 1 < path.size(); i++) {
+        length += path[i].distTo(path[i + 1]);
+    }
+    return length;
+}
+
+}  // namespace
+
+TEST(RRTPlannerTest, cubicBezierCalcMatchesDenseSolve) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> coord(-4, 4);
+    std::uniform_real_distribution<double> velocity(-2, 2);
+    std::uniform_real_distribution<double> duration(0.05, 2);
+
+    // Including the one and two curve cases, which have no or one inner point
+    for (int count : {2, 3, 4, 7, 20}) {
+        for (int run = 0; run < 20; run++) {
+            std::vector<Point> points;
+            std::vector<double> ks;
+            for (int i = 0; i < count; i++) {
+                points.emplace_back(coord(gen), coord(gen));
+                if (i > 0) {
+                    ks.push_back(1 / duration(gen));
+                }
+            }
+            const Point vi(velocity(gen), velocity(gen));
+            const Point vf(velocity(gen), velocity(gen));
+
+            std::vector<Point> velocities;
+            BezierPlanner::cubicBezierCalc(vi, vf, points, ks, velocities);
+            const std::vector<Point> expected =
+                denseBezierVelocities(vi, vf, points, ks);
+
+            ASSERT_EQ(expected.size(), velocities.size());
+            for (int i = 0; i < count; i++) {
+                EXPECT_NEAR(expected[i].x(), velocities[i].x(), 1e-8)
+                    << count << " points, point " << i;
+                EXPECT_NEAR(expected[i].y(), velocities[i].y(), 1e-8)
+                    << count << " points, point " << i;
+            }
+        }
+    }
+}
+
+TEST(RRTPlannerTest, shortcutPathShortensPath) {
+    // A zigzag up the field, with an obstacle that's in the way of going
+    // straight from one end to the other
+    std::vector<Point> zigzag;
+    for (int i = 0; i < 8; i++) {
+        zigzag.emplace_back(i % 2 ? 1 : -1, 1 + i);
+    }
+    ShapeSet obstacles;
+    obstacles.add(std::make_shared<Circle>(Point(0, 5), 0.2));
+    const RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                       obstacles);
+    for (int i = 0; i + 1 < zigzag.size(); i++) {
+        ASSERT_TRUE(stateSpace.transitionValid(zigzag[i], zigzag[i + 1]));
+    }
+    ASSERT_FALSE(stateSpace.transitionValid(zigzag.front(), zigzag.back()));
+
+    ShortcutPlanner planner;
+
+    // Nothing changes once the deadline has passed
+    std::vector<Point> path = zigzag;
+    planner.shortcutPath(path, stateSpace, RJ::now() - 1ms);
+    EXPECT_EQ(zigzag, path);
+
+    // With time to spare, it goes most of the way straight
+    planner.shortcutPath(path, stateSpace, RJ::now() + 1s);
+    EXPECT_EQ(zigzag.front(), path.front());
+    EXPECT_EQ(zigzag.back(), path.back());
+    EXPECT_LT(pathLength(path), pathLength(zigzag) * 0.6);
+    for (int i = 0; i + 1 < path.size(); i++) {
+        EXPECT_TRUE(stateSpace.transitionValid(path[i], path[i + 1]))
+            << "Shortcut " << i << " enters the obstacle";
+    }
+}
+
+TEST(RRTPlannerTest, repairsBlockedPath) {
+    SystemState systemState;
+    // Enough iterations that the RRT doesn't give up on the way around the
+    // obstacle, which would fall back to a full replan
+    RRTPlanner planner(100, 1000);
+
+    const MotionInstant start({0, 0}, {0, 0});
+    const MotionInstant goal({0, 6}, {0, 0});
+
+    PlanRequest first(systemState, start,
+                      std::make_unique<PathTargetCommand>(goal),
+                      RobotConstraints(), nullptr, ShapeSet(), {}, 0);
+    std::unique_ptr<Path> prevPath = planner.run(first);
+    ASSERT_NE(nullptr, prevPath);
+    prevPath->setStartTime(RJ::now());
+
+    // Something moves onto the middle of the path
+    ShapeSet obstacles;
+    obstacles.add(std::make_shared<Circle>(Point(0, 3), 0.3));
+    ASSERT_TRUE(prevPath->hit(obstacles, 0s));
+    const RobotInstant prevEnd = prevPath->end();
+
+    PlanRequest second(systemState, start,
+                       std::make_unique<PathTargetCommand>(goal),
+                       RobotConstraints(), std::move(prevPath), obstacles, {},
+                       0);
+    std::unique_ptr<Path> path = planner.run(second);
+    ASSERT_NE(nullptr, path);
+
+    // Only the blocked part was replanned, so the path still ends the same way
+    EXPECT_EQ(1, planner.replanStats().repairs);
+    EXPECT_EQ(0, planner.replanStats().replans);
+    EXPECT_FALSE(path->hit(obstacles, 0s)) << "Repaired path hits obstacles";
+    EXPECT_NEAR(0, (path->end().motion.pos - prevEnd.motion.pos).mag(), 1e-6);
+}
+
+}  // namespace Planning
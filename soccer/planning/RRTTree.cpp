@@ -0,0 +1,299 @@
+#include "RRTTree.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+using namespace Geometry2d;
+
+namespace Planning {
+
+namespace {
+
+// Size of the grid cells BiRRT uses.  A few RRT steps across, so a nearest
+// node query usually only has to look at one ring of cells.
+constexpr double BiRRTGridCellSize = 0.3;
+
+}  // namespace
+
+void RRTTree::reset(Point root) {
+    _xs.clear();
+    _ys.clear();
+    _parents.clear();
+    _depths.clear();
+    _nextInCell.clear();
+    if (hasGrid()) {
+        _cellHeads.assign(_gridColumns * _gridRows, -1);
+    }
+    add(root, -1);
+}
+
+void RRTTree::setGrid(Point min, Point max, double cellSize) {
+    _gridMin = min;
+    _gridCellSize = cellSize;
+    _gridColumns = std::max(1, int(std::ceil((max.x() - min.x()) / cellSize)));
+    _gridRows = std::max(1, int(std::ceil((max.y() - min.y()) / cellSize)));
+}
+
+int RRTTree::gridColumn(double x) const {
+    const int col = std::floor((x - _gridMin.x()) / _gridCellSize);
+    return std::min(std::max(col, 0), _gridColumns - 1);
+}
+
+int RRTTree::gridRow(double y) const {
+    const int row = std::floor((y - _gridMin.y()) / _gridCellSize);
+    return std::min(std::max(row, 0), _gridRows - 1);
+}
+
+int RRTTree::add(Point state, int parent) {
+    const int index = _parents.size();
+    _xs.push_back(state.x());
+    _ys.push_back(state.y());
+    _parents.push_back(parent);
+    _depths.push_back(parent < 0 ? 0 : _depths[parent] + 1);
+
+    if (hasGrid()) {
+        const int cell =
+            gridRow(state.y()) * _gridColumns + gridColumn(state.x());
+        _nextInCell.push_back(_cellHeads[cell]);
+        _cellHeads[cell] = index;
+    }
+    return index;
+}
+
+void RRTTree::nearestInCell(int col, int row, Point target, int& best,
+                            double& bestDistSq) const {
+    for (int i = _cellHeads[row * _gridColumns + col]; i >= 0;
+         i = _nextInCell[i]) {
+        const double dx = _xs[i] - target.x();
+        const double dy = _ys[i] - target.y();
+        const double distSq = dx * dx + dy * dy;
+        // Break ties by index to match the full scan
+        if (distSq < bestDistSq || (distSq == bestDistSq && i < best)) {
+            bestDistSq = distSq;
+            best = i;
+        }
+    }
+}
+
+int RRTTree::nearestInGrid(Point target) const {
+    const int col = gridColumn(target.x());
+    const int row = gridRow(target.y());
+    const int maxRing =
+        std::max({col, row, _gridColumns - 1 - col, _gridRows - 1 - row});
+
+    // Search rings of cells around the target's cell.  Everything in ring r
+    // is at least (r - 1) cells away, so once the best node is closer than
+    // that the rest can be skipped.
+    int best = -1;
+    double bestDistSq = std::numeric_limits<double>::infinity();
+    for (int r = 0; r <= maxRing; r++) {
+        const double ringDist = (r - 1) * _gridCellSize;
+        if (r > 1 && ringDist * ringDist > bestDistSq) {
+            break;
+        }
+
+        const int minCol = std::max(col - r, 0);
+        const int maxCol = std::min(col + r, _gridColumns - 1);
+        const int minRow = std::max(row - r, 0);
+        const int maxRow = std::min(row + r, _gridRows - 1);
+        for (int y = minRow; y <= maxRow; y++) {
+            // The middle rows only have cells at the ends of the ring
+            const bool edgeRow = y == row - r || y == row + r;
+            const int step = edgeRow ? 1 : 2 * r;
+            for (int x = col - r; x <= col + r; x += std::max(step, 1)) {
+                if (x >= minCol && x <= maxCol) {
+                    nearestInCell(x, y, target, best, bestDistSq);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+int RRTTree::shallowestWithinInGrid(Point target, double maxDist) const {
+    const double maxDistSq = maxDist * maxDist;
+    int best = -1;
+    int bestDepth = INT_MAX;
+    for (int y = gridRow(target.y() - maxDist);
+         y <= gridRow(target.y() + maxDist); y++) {
+        for (int x = gridColumn(target.x() - maxDist);
+             x <= gridColumn(target.x() + maxDist); x++) {
+            for (int i = _cellHeads[y * _gridColumns + x]; i >= 0;
+                 i = _nextInCell[i]) {
+                const double dx = _xs[i] - target.x();
+                const double dy = _ys[i] - target.y();
+                if (dx * dx + dy * dy < maxDistSq &&
+                    (_depths[i] < bestDepth ||
+                     (_depths[i] == bestDepth && i < best))) {
+                    bestDepth = _depths[i];
+                    best = i;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+int RRTTree::nearest(Point target) const {
+    if (hasGrid()) {
+        // The nearest node is no farther than the newest one, so this bounds
+        // how many rings the grid search could take.  When that's more cells
+        // than there are nodes (small trees, or targets far from the tree),
+        // checking every node is faster.
+        const Point newest = state(size() - 1);
+        const int rings = (newest - target).mag() / _gridCellSize + 2;
+        if ((2 * rings + 1) * (2 * rings + 1) < size()) {
+            return nearestInGrid(target);
+        }
+    }
+
+    int best = -1;
+    double bestDistSq = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < _xs.size(); i++) {
+        const double dx = _xs[i] - target.x();
+        const double dy = _ys[i] - target.y();
+        const double distSq = dx * dx + dy * dy;
+        if (distSq < bestDistSq) {
+            bestDistSq = distSq;
+            best = i;
+        }
+    }
+    return best;
+}
+
+int RRTTree::shallowestWithin(Point target, double maxDist) const {
+    if (hasGrid()) {
+        return shallowestWithinInGrid(target, maxDist);
+    }
+
+    const double maxDistSq = maxDist * maxDist;
+    int best = -1;
+    int bestDepth = INT_MAX;
+    for (int i = 0; i < _xs.size(); i++) {
+        const double dx = _xs[i] - target.x();
+        const double dy = _ys[i] - target.y();
+        if (dx * dx + dy * dy < maxDistSq && _depths[i] < bestDepth) {
+            bestDepth = _depths[i];
+            best = i;
+        }
+    }
+    return best;
+}
+
+int RRTTree::extend(const RoboCupStateSpace& stateSpace, Point target,
+                    double stepSize) {
+    const int source = nearest(target);
+    if (source < 0) {
+        return -1;
+    }
+
+    const Point from = state(source);
+    const Point to = stateSpace.intermediateState(from, target, stepSize);
+    if (!stateSpace.transitionValid(from, to)) {
+        return -1;
+    }
+
+    return add(to, source);
+}
+
+void RRTTree::appendPathToRoot(int index, std::vector<Point>& out) const {
+    for (; index >= 0; index = _parents[index]) {
+        out.push_back(state(index));
+    }
+}
+
+BiRRT::BiRRT() : _random(std::random_device{}()) {}
+
+bool BiRRT::run(const RoboCupStateSpace& stateSpace) {
+    if (_useGrid) {
+        // Cover the area randomState() picks from
+        const Field_Dimensions& dims = stateSpace.fieldDimensions();
+        const Point min(-dims.FloorWidth() / 2, -dims.Border());
+        const Point max(dims.FloorWidth() / 2,
+                        dims.FloorLength() - dims.Border());
+        _startTree.setGrid(min, max, BiRRTGridCellSize);
+        _goalTree.setGrid(min, max, BiRRTGridCellSize);
+    } else {
+        _startTree.clearGrid();
+        _goalTree.clearGrid();
+    }
+
+    _startTree.reset(_startState);
+    _goalTree.reset(_goalState);
+    _startSolutionNode = -1;
+    _goalSolutionNode = -1;
+    _solutionLength = INT_MAX;
+
+    for (_iterationCount = 0; _iterationCount < _maxIterations;) {
+        const int newStartNode = growTree(stateSpace, _startTree, _goalState);
+        if (newStartNode >= 0) {
+            tryConnect(stateSpace, _startTree, newStartNode, _goalTree, true);
+        }
+
+        const int newGoalNode = growTree(stateSpace, _goalTree, _startState);
+        if (newGoalNode >= 0) {
+            tryConnect(stateSpace, _goalTree, newGoalNode, _startTree, false);
+        }
+
+        _iterationCount++;
+        const bool found = _startSolutionNode >= 0;
+        if (found && (_deadline ? RJ::now() >= *_deadline
+                                : _iterationCount > _minIterations)) {
+            return true;
+        }
+    }
+
+    return _startSolutionNode >= 0;
+}
+
+int BiRRT::growTree(const RoboCupStateSpace& stateSpace, RRTTree& tree,
+                    Point towards) {
+    std::uniform_real_distribution<double> unit(0, 1);
+    const double r = unit(_random);
+
+    Point target;
+    if (r < _goalBias) {
+        target = towards;
+    } else if (r < _goalBias + _waypointBias && !_waypoints.empty()) {
+        std::uniform_int_distribution<int> pick(0, _waypoints.size() - 1);
+        target = _waypoints[pick(_random)];
+    } else {
+        target = stateSpace.randomState();
+    }
+
+    return tree.extend(stateSpace, target, _stepSize);
+}
+
+void BiRRT::tryConnect(const RoboCupStateSpace& stateSpace,
+                       const RRTTree& tree, int newNode,
+                       const RRTTree& otherTree, bool fromStart) {
+    const Point state = tree.state(newNode);
+    const int otherNode = otherTree.shallowestWithin(state, _goalMaxDist);
+    if (otherNode < 0) {
+        return;
+    }
+
+    const int length = tree.depth(newNode) + otherTree.depth(otherNode);
+    if (length < _solutionLength &&
+        stateSpace.transitionValid(state, otherTree.state(otherNode))) {
+        _startSolutionNode = fromStart ? newNode : otherNode;
+        _goalSolutionNode = fromStart ? otherNode : newNode;
+        _solutionLength = length;
+    }
+}
+
+std::vector<Point> BiRRT::getPath() const {
+    std::vector<Point> path;
+    if (_startSolutionNode < 0) {
+        return path;
+    }
+
+    _startTree.appendPathToRoot(_startSolutionNode, path);
+    std::reverse(path.begin(), path.end());
+    _goalTree.appendPathToRoot(_goalSolutionNode, path);
+    return path;
+}
+
+}  // namespace Planning
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <Geometry2d/Point.hpp>
+#include <time.hpp>
+#include "RoboCupStateSpace.hpp"
+
+namespace Planning {
+
+/**
+ * @brief An RRT tree of points, stored in arrays that are kept between runs.
+ *
+ * @details Nodes are referred to by their index, with the root at index zero.
+ * The node positions are kept in separate x and y arrays so nearest() scans
+ * contiguous memory.  reset() clears the tree but keeps the arrays' capacity,
+ * so a tree that's reused for every plan stops allocating once it has grown
+ * to the largest size it's needed.
+ *
+ * Scanning every node makes growing the tree quadratic in its size.  With
+ * setGrid(), nodes are also bucketed into a fixed grid and queries only look
+ * at the cells near the query point, unless scanning would check fewer nodes
+ * than that.  Both give the same results.
+ */
+class RRTTree {
+public:
+    /// Clears the tree, leaving only a root node at @root
+    void reset(Geometry2d::Point root);
+
+    /**
+     * Buckets the nodes in a grid covering @min to @max with cells @cellSize
+     * across.  Nodes outside of it go in the closest cell at the edge.  Takes
+     * effect at the next reset().
+     */
+    void setGrid(Geometry2d::Point min, Geometry2d::Point max, double cellSize);
+
+    /// Goes back to scanning every node
+    void clearGrid() { _gridCellSize = 0; }
+
+    bool hasGrid() const { return _gridCellSize > 0; }
+
+    int size() const { return _parents.size(); }
+
+    Geometry2d::Point state(int index) const {
+        return Geometry2d::Point(_xs[index], _ys[index]);
+    }
+
+    /// Index of the parent of node @index, or -1 for the root
+    int parent(int index) const { return _parents[index]; }
+
+    /// Number of edges from node @index to the root
+    int depth(int index) const { return _depths[index]; }
+
+    /// Index of the node closest to @target
+    int nearest(Geometry2d::Point target) const;
+
+    /**
+     * Finds the shallowest node closer than @maxDist to @target
+     *
+     * @return the node's index, or -1 if no node is close enough
+     */
+    int shallowestWithin(Geometry2d::Point target, double maxDist) const;
+
+    /**
+     * Adds a node one step from the node nearest @target toward it, if the
+     * transition is valid.
+     *
+     * @return the new node's index, or -1 if it wasn't added
+     */
+    int extend(const RoboCupStateSpace& stateSpace, Geometry2d::Point target,
+               double stepSize);
+
+    /// Appends the states from node @index up to the root to @out
+    void appendPathToRoot(int index, std::vector<Geometry2d::Point>& out) const;
+
+private:
+    int add(Geometry2d::Point state, int parent);
+
+    int gridColumn(double x) const;
+    int gridRow(double y) const;
+
+    /// Checks the nodes in cell (@col, @row) for one closer than @bestDistSq
+    void nearestInCell(int col, int row, Geometry2d::Point target, int& best,
+                       double& bestDistSq) const;
+
+    int nearestInGrid(Geometry2d::Point target) const;
+    int shallowestWithinInGrid(Geometry2d::Point target, double maxDist) const;
+
+    std::vector<double> _xs;
+    std::vector<double> _ys;
+    std::vector<int> _parents;
+    std::vector<int> _depths;
+
+    // Each grid cell is a linked list of the nodes in it, from _cellHeads
+    // through _nextInCell, ending with -1
+    std::vector<int> _cellHeads;
+    std::vector<int> _nextInCell;
+    Geometry2d::Point _gridMin;
+    double _gridCellSize = 0;
+    int _gridColumns = 0;
+    int _gridRows = 0;
+};
+
+/**
+ * @brief Bi-directional RRT between two points that reuses its trees.
+ *
+ * @details Grows one tree from the start and one from the goal until a node
+ * in one is close enough to a node in the other to connect them.  This
+ * behaves like RRT::BiRRT from the rrt library, but it's specialized for
+ * points and keeps its trees between runs.  Keep one per planner and call
+ * run() for each plan.
+ */
+class BiRRT {
+public:
+    BiRRT();
+
+    void setStartState(Geometry2d::Point start) { _startState = start; }
+    void setGoalState(Geometry2d::Point goal) { _goalState = goal; }
+
+    void setStepSize(double stepSize) { _stepSize = stepSize; }
+
+    /// Max distance between nodes in the two trees for them to be connected
+    void setGoalMaxDist(double maxDist) { _goalMaxDist = maxDist; }
+
+    /// Proportion of the time each tree grows toward the other tree's root
+    void setGoalBias(double goalBias) { _goalBias = goalBias; }
+
+    /// Proportion of the time each tree grows toward a random waypoint
+    void setWaypointBias(double waypointBias) { _waypointBias = waypointBias; }
+    void setWaypoints(const std::vector<Geometry2d::Point>& waypoints) {
+        _waypoints = waypoints;
+    }
+    void clearWaypoints() { _waypoints.clear(); }
+
+    void setMinIterations(int iterations) { _minIterations = iterations; }
+    void setMaxIterations(int iterations) { _maxIterations = iterations; }
+
+    /**
+     * With a deadline, run() keeps looking for a shorter path until the
+     * deadline instead of stopping after the min iterations.  It only stops
+     * at the deadline once it has a path, so without one it still runs up to
+     * the max iterations.
+     */
+    void setDeadline(std::optional<RJ::Time> deadline) { _deadline = deadline; }
+
+    /// Whether the trees use a grid over the field for nearest node queries.
+    /// See RRTTree::setGrid().
+    void setUseGrid(bool useGrid) { _useGrid = useGrid; }
+
+    /**
+     * Clears the trees and grows them from the start and goal states until a
+     * path is found and at least the min iterations have run, or the max
+     * iterations have run.  See setDeadline() for how a deadline changes
+     * that.
+     *
+     * @return true if a path was found
+     */
+    bool run(const RoboCupStateSpace& stateSpace);
+
+    /// Number of iterations the last run() took
+    int iterationCount() const { return _iterationCount; }
+
+    /// The path found by the last run(), from the start state to the goal
+    /// state
+    std::vector<Geometry2d::Point> getPath() const;
+
+    const RRTTree& startTree() const { return _startTree; }
+    const RRTTree& goalTree() const { return _goalTree; }
+
+private:
+    /// Grows @tree one step, toward @towards or a waypoint or random point
+    int growTree(const RoboCupStateSpace& stateSpace, RRTTree& tree,
+                 Geometry2d::Point towards);
+
+    /// Connects new node @newNode in @tree to @otherTree if that gives a
+    /// shorter solution
+    void tryConnect(const RoboCupStateSpace& stateSpace, const RRTTree& tree,
+                    int newNode, const RRTTree& otherTree, bool fromStart);
+
+    RRTTree _startTree;
+    RRTTree _goalTree;
+
+    Geometry2d::Point _startState;
+    Geometry2d::Point _goalState;
+    std::vector<Geometry2d::Point> _waypoints;
+
+    double _stepSize = 0.1;
+    double _goalMaxDist = 0.1;
+    double _goalBias = 0;
+    double _waypointBias = 0;
+    int _minIterations = 0;
+    int _maxIterations = 1000;
+    bool _useGrid = false;
+    std::optional<RJ::Time> _deadline;
+
+    int _iterationCount = 0;
+
+    // The connected nodes in each tree, or -1
+    int _startSolutionNode = -1;
+    int _goalSolutionNode = -1;
+    int _solutionLength = 0;
+
+    std::mt19937 _random;
+};
+
+}  // namespace Planning
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <Benchmark.hpp>
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/Rect.hpp>
+#include <planning/RRTTree.hpp>
+#include <rrt/BiRRT.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+
+using namespace Geometry2d;
+
+namespace {
+
+// Allocations made on this thread while an AllocationCounter is alive.  The
+// replacement operator new is global, but only the benchmarks in this file
+// turn counting on, so nothing else in the binary is counted.
+thread_local bool countingAllocations = false;
+thread_local long allocations = 0;
+
+class AllocationCounter {
+public:
+    AllocationCounter() : _start(allocations) { countingAllocations = true; }
+    ~AllocationCounter() { countingAllocations = false; }
+
+    long count() const { return allocations - _start; }
+
+private:
+    long _start;
+};
+
+}  // namespace
+
+void* operator new(size_t size) {
+    if (countingAllocations) {
+        allocations++;
+    }
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace Planning {
+
+namespace {
+
+/// Robots scattered over the field, like the obstacles the planner sees
+ShapeSet robotObstacles() {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> x(-3, 3);
+    std::uniform_real_distribution<double> y(1.5, 7.5);
+
+    ShapeSet obstacles;
+    for (int i = 0; i < 11; i++) {
+        obstacles.add(std::make_shared<Circle>(Point(x(gen), y(gen)), 0.2));
+    }
+    return obstacles;
+}
+
+/// Works for both our BiRRT and the rrt library's, which have the same
+/// setters
+template <typename Tree>
+void setup(Tree& biRRT, int iterations) {
+    biRRT.setStartState(Point(-2, 0.5));
+    biRRT.setGoalState(Point(2, 8.5));
+    biRRT.setStepSize(0.15);
+    biRRT.setGoalBias(0.3);
+
+    // Always run the full number of iterations so both cases do the same
+    // work
+    biRRT.setMinIterations(iterations);
+    biRRT.setMaxIterations(iterations);
+}
+
+/// Times @plan and reports the time and allocations per call
+template <typename F>
+void measure(const std::string& name, int plans, F&& plan) {
+    AllocationCounter counter;
+    int runs = 0;
+    Benchmark::report(name, Benchmark::nsPerIteration(plans, [&](int) {
+                          plan();
+                          runs++;
+                      }));
+    printf("[ BENCH    ] %-48s %12.1f allocs/plan\n", name.c_str(),
+           double(counter.count()) / runs);
+}
+
+void compare(int iterations) {
+    const ShapeSet obstacles = robotObstacles();
+    const RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                       obstacles);
+    const int plans = 2000;
+    const std::string name = "BiRRT " + std::to_string(iterations) + " its";
+
+    // The rrt library's BiRRT and a shared state space, made for every plan
+    // like RRTPlanner used to
+    measure(name + " (rrt library)", plans, [&] {
+        RRT::BiRRT<Point> biRRT(
+            std::make_shared<RoboCupStateSpace>(
+                Field_Dimensions::Current_Dimensions, obstacles),
+            Point::hash, 2);
+        setup(biRRT, iterations);
+        Benchmark::doNotOptimize(biRRT.run());
+    });
+
+    // Our BiRRT made for every plan, which separates what keeping the trees
+    // saves from the other differences with the library
+    measure(name + " (new each plan)", plans, [&] {
+        BiRRT biRRT;
+        setup(biRRT, iterations);
+        Benchmark::doNotOptimize(biRRT.run(stateSpace));
+    });
+
+    BiRRT biRRT;
+    setup(biRRT, iterations);
+    measure(name + " (reused)", plans,
+            [&] { Benchmark::doNotOptimize(biRRT.run(stateSpace)); });
+}
+
+/// A crowded defense: our penalty area, with robots packed around its edge
+/// and a few more in front of it
+ShapeSet penaltyAreaObstacles() {
+    const Field_Dimensions& dims = Field_Dimensions::Current_Dimensions;
+    const double halfLong = dims.PenaltyLongDist() / 2;
+    const double shortDist = dims.PenaltyShortDist();
+
+    ShapeSet obstacles;
+    obstacles.add(std::make_shared<Rect>(Point(-halfLong, 0),
+                                         Point(halfLong, shortDist)));
+    for (int i = 0; i < 8; i++) {
+        const double x = -halfLong + 2 * halfLong * i / 7;
+        obstacles.add(
+            std::make_shared<Circle>(Point(x, shortDist + 0.15), 0.2));
+    }
+    for (int i = 0; i < 4; i++) {
+        obstacles.add(std::make_shared<Circle>(
+            Point(-halfLong + 0.5 + i * 0.7, shortDist + 0.8), 0.2));
+    }
+    return obstacles;
+}
+
+void compareNearest(int iterations) {
+    const ShapeSet obstacles = penaltyAreaObstacles();
+    const RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                       obstacles);
+    const int plans = 200;
+
+    for (bool useGrid : {false, true}) {
+        BiRRT biRRT;
+        setup(biRRT, iterations);
+
+        // From midfield to the edge of the crowd beside the penalty area
+        biRRT.setGoalState(
+            Point(Field_Dimensions::Current_Dimensions.PenaltyLongDist() / 2 +
+                      0.3,
+                  0.3));
+        biRRT.setUseGrid(useGrid);
+
+        const double ns = Benchmark::nsPerIteration(plans, [&](int) {
+            Benchmark::doNotOptimize(biRRT.run(stateSpace));
+        });
+        const std::string name = "BiRRT penalty area " +
+                                 std::to_string(iterations) + " its (" +
+                                 (useGrid ? "grid" : "scan") + ")";
+        Benchmark::report(name, ns);
+        printf("[ BENCH    ] %-48s %12.1f its/ms\n", name.c_str(),
+               iterations / (ns / 1e6));
+    }
+}
+
+}  // namespace
+
+TEST(RRTTreeBenchmark, iterations250) { compare(250); }
+
+TEST(RRTTreeBenchmark, iterations500) { compare(500); }
+
+TEST(RRTTreeBenchmark, nearestPenaltyArea) {
+    compareNearest(250);
+    compareNearest(500);
+    compareNearest(1000);
+}
+
+}  // namespace Planning
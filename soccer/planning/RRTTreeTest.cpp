@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <Geometry2d/Circle.hpp>
+#include <planning/RRTTree.hpp>
+
+#include <random>
+
+using namespace Geometry2d;
+
+namespace Planning {
+
+namespace {
+
+void expectValidPath(const std::vector<Point>& path, Point start, Point goal,
+                     const RoboCupStateSpace& stateSpace) {
+    ASSERT_GE(path.size(), 2);
+    EXPECT_EQ(start, path.front());
+    EXPECT_EQ(goal, path.back());
+    for (int i = 1; i < path.size(); i++) {
+        EXPECT_TRUE(stateSpace.transitionValid(path[i - 1], path[i]));
+    }
+}
+
+}  // namespace
+
+TEST(BiRRT, straightLine) {
+    ShapeSet obstacles;
+    RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                 obstacles);
+
+    BiRRT biRRT;
+    biRRT.setStartState(Point(0, 1));
+    biRRT.setGoalState(Point(1, 3));
+    biRRT.setStepSize(Point(0, 1).distTo(Point(1, 3)));
+    biRRT.setGoalBias(1);
+    biRRT.setMaxIterations(5);
+
+    ASSERT_TRUE(biRRT.run(stateSpace));
+    EXPECT_EQ(1, biRRT.iterationCount());
+    expectValidPath(biRRT.getPath(), Point(0, 1), Point(1, 3), stateSpace);
+}
+
+TEST(BiRRT, aroundObstacle) {
+    ShapeSet obstacles;
+    obstacles.add(std::make_shared<Circle>(Point(0, 3), 0.5));
+    RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                 obstacles);
+
+    BiRRT biRRT;
+    biRRT.setStepSize(0.15);
+    biRRT.setGoalBias(0.3);
+    biRRT.setMaxIterations(2000);
+
+    // The same object plans every time, like it does in RRTPlanner
+    for (int i = 0; i < 5; i++) {
+        const Point start(0, 1 + 0.1 * i);
+        const Point goal(0.1 * i, 5);
+        biRRT.setStartState(start);
+        biRRT.setGoalState(goal);
+
+        ASSERT_TRUE(biRRT.run(stateSpace));
+        expectValidPath(biRRT.getPath(), start, goal, stateSpace);
+        EXPECT_LE(biRRT.iterationCount(), 2000);
+    }
+}
+
+TEST(BiRRT, blockedStraightLine) {
+    ShapeSet obstacles;
+    obstacles.add(std::make_shared<Circle>(Point(0, 3), 0.5));
+    RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                 obstacles);
+
+    BiRRT biRRT;
+    biRRT.setStartState(Point(0, 1));
+    biRRT.setGoalState(Point(0, 5));
+    biRRT.setStepSize(4);
+    biRRT.setGoalBias(1);
+    biRRT.setMaxIterations(5);
+
+    EXPECT_FALSE(biRRT.run(stateSpace));
+    EXPECT_TRUE(biRRT.getPath().empty());
+    EXPECT_EQ(5, biRRT.iterationCount());
+}
+
+TEST(BiRRT, deadline) {
+    ShapeSet obstacles;
+    obstacles.add(std::make_shared<Circle>(Point(0, 3), 0.5));
+    RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                 obstacles);
+
+    BiRRT biRRT;
+    biRRT.setStartState(Point(0, 1));
+    biRRT.setGoalState(Point(0, 5));
+    biRRT.setStepSize(0.15);
+    biRRT.setGoalBias(0.3);
+    biRRT.setMinIterations(10);
+    biRRT.setMaxIterations(1000);
+
+    // Past the deadline, it stops as soon as it has a path
+    biRRT.setDeadline(RJ::now());
+    ASSERT_TRUE(biRRT.run(stateSpace));
+    EXPECT_LT(biRRT.iterationCount(), 1000);
+    expectValidPath(biRRT.getPath(), Point(0, 1), Point(0, 5), stateSpace);
+
+    // Before it, it keeps looking for a shorter path up to the max iterations
+    biRRT.setDeadline(RJ::now() + RJ::Seconds(10));
+    ASSERT_TRUE(biRRT.run(stateSpace));
+    EXPECT_EQ(1000, biRRT.iterationCount());
+    expectValidPath(biRRT.getPath(), Point(0, 1), Point(0, 5), stateSpace);
+
+    // Without a path, the deadline doesn't stop it before the max iterations
+    biRRT.setStepSize(4);
+    biRRT.setGoalBias(1);
+    biRRT.setDeadline(RJ::now());
+    EXPECT_FALSE(biRRT.run(stateSpace));
+    EXPECT_EQ(1000, biRRT.iterationCount());
+}
+
+TEST(RRTTree, gridMatchesScan) {
+    ShapeSet obstacles;
+    RoboCupStateSpace stateSpace(Field_Dimensions::Current_Dimensions,
+                                 obstacles);
+
+    RRTTree scan;
+    RRTTree grid;
+    grid.setGrid(Point(-3, -0.5), Point(3, 9.5), 0.3);
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> x(-4, 4);
+    std::uniform_real_distribution<double> y(-1.5, 10.5);
+
+    // Reuse the trees like BiRRT does, with queries both inside and outside
+    // the grid
+    for (int run = 0; run < 3; run++) {
+        scan.reset(Point(0, 1));
+        grid.reset(Point(0, 1));
+        for (int i = 0; i < 500; i++) {
+            const Point target(x(gen), y(gen));
+            ASSERT_EQ(scan.nearest(target), grid.nearest(target));
+            EXPECT_EQ(scan.shallowestWithin(target, 0.5),
+                      grid.shallowestWithin(target, 0.5));
+
+            scan.extend(stateSpace, target, 0.15);
+            grid.extend(stateSpace, target, 0.15);
+        }
+        ASSERT_EQ(scan.size(), grid.size());
+    }
+}
+
+}  // namespace Planning
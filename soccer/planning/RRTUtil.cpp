@@ -11,6 +11,9 @@ ConfigBool* RRTConfig::EnableRRTDebugDrawing;
 ConfigDouble* RRTConfig::StepSize;
 ConfigDouble* RRTConfig::GoalBias;
 ConfigDouble* RRTConfig::WaypointBias;
+ConfigBool* RRTConfig::NearestNeighborGrid;
+ConfigInt* RRTConfig::AnytimeMaxIterations;
+ConfigDouble* RRTConfig::AnytimeRRTFraction;
 
 void RRTConfig::createConfiguration(Configuration* cfg) {
     EnableRRTDebugDrawing =
@@ -25,29 +28,42 @@ void RRTConfig::createConfiguration(Configuration* cfg) {
         "Value from 0 to 1 that determines the portion of the time that the "
         "RRT will"
         " grow towards given waypoints rather than towards a random point");
+    NearestNeighborGrid =
+        new ConfigBool(cfg, "PathPlanner/RRT/NearestNeighborGrid", true);
+    AnytimeMaxIterations =
+        new ConfigInt(cfg, "PathPlanner/RRT/AnytimeMaxIterations", 1000);
+    AnytimeRRTFraction = new ConfigDouble(
+        cfg, "PathPlanner/RRT/AnytimeRRTFraction", 0.5,
+        "Value from 0 to 1 that determines what proportion of the time left "
+        "before a plan's deadline the RRT gets.  The rest is for shortening "
+        "its path and trying other paths.");
 }
 
 ConfigBool EnableExpensiveRRTDebugDrawing();
 
-void DrawRRT(const RRT::Tree<Point>& rrt, SystemState* state,
-             unsigned shellID) {
-    // Draw each robot's rrts in a different color
-    // Note: feel free to change these, they're completely arbitrary
+namespace {
+
+// Draw each robot's rrts in a different color
+// Note: feel free to change these, they're completely arbitrary
+QColor rrtColor(unsigned shellID) {
     static const std::array<QColor, 6> colors = {
         QColor("green"), QColor("blue"),   QColor("yellow"),
         QColor("red"),   QColor("purple"), QColor("orange")};
-    QColor color = colors[shellID % colors.size()];
+    return colors[shellID % colors.size()];
+}
+
+}  // namespace
+
+void DrawRRT(const RRTTree& rrt, SystemState* state, unsigned shellID) {
+    QColor color = rrtColor(shellID);
 
-    for (auto& node : rrt.allNodes()) {
-        if (node.parent()) {
-            state->drawLine(Segment(node.state(), node.parent()->state()),
-                            color, QString("RobotRRT%1").arg(shellID));
-        }
+    for (int i = 1; i < rrt.size(); i++) {
+        state->drawLine(Segment(rrt.state(i), rrt.state(rrt.parent(i))),
+                        color, QString("RobotRRT%1").arg(shellID));
     }
 }
 
-void DrawBiRRT(const RRT::BiRRT<Point>& biRRT, SystemState* state,
-               unsigned shellID) {
+void DrawBiRRT(const BiRRT& biRRT, SystemState* state, unsigned shellID) {
     DrawRRT(biRRT.startTree(), state, shellID);
     DrawRRT(biRRT.goalTree(), state, shellID);
 }
@@ -1,5 +1,5 @@
 #include <Geometry2d/Point.hpp>
-#include <rrt/BiRRT.hpp>
+#include "RRTTree.hpp"
 #include "Configuration.hpp"
 #include "SystemState.hpp"
 
@@ -16,11 +16,22 @@ public:
     static ConfigDouble* StepSize;
     static ConfigDouble* GoalBias;
     static ConfigDouble* WaypointBias;
+
+    // if set, the RRT finds nearest nodes with a grid over the field rather
+    // than checking every node
+    static ConfigBool* NearestNeighborGrid;
+
+    // max iterations of the RRT when planning to a deadline.  The RRT keeps
+    // looking for a shorter path until its share of the time is up, up to
+    // this many iterations.
+    static ConfigInt* AnytimeMaxIterations;
+
+    // share of the time left before a deadline that each RRT run gets.  The
+    // rest goes to shortcutting its path and to trying other paths.
+    static ConfigDouble* AnytimeRRTFraction;
 };
 
 /// Drawing
-void DrawRRT(const RRT::Tree<Geometry2d::Point>& rrt, SystemState* state,
-             unsigned shellID);
-void DrawBiRRT(const RRT::BiRRT<Geometry2d::Point>& biRRT, SystemState* state,
-               unsigned shellID);
+void DrawRRT(const RRTTree& rrt, SystemState* state, unsigned shellID);
+void DrawBiRRT(const BiRRT& biRRT, SystemState* state, unsigned shellID);
 }  // Planning
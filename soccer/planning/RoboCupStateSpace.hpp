@@ -1,6 +1,12 @@
 #pragma once
 
+#include <random>
+#include <stdexcept>
+
+#include <Field_Dimensions.hpp>
 #include <Geometry2d/Point.hpp>
+#include <Geometry2d/Segment.hpp>
+#include <Geometry2d/ShapeSet.hpp>
 #include <rrt/2dplane/PlaneStateSpace.hpp>
 
 namespace Planning {
@@ -8,15 +14,22 @@ namespace Planning {
 /**
  * Represents the robocup field for path-planning purposes.
  */
-class RoboCupStateSpace : public RRT::StateSpace<Geometry2d::Point> {
+class RoboCupStateSpace final : public RRT::StateSpace<Geometry2d::Point> {
 public:
     RoboCupStateSpace(const Field_Dimensions& dims,
                       const Geometry2d::ShapeSet& obstacles)
         : _fieldDimensions(dims), _obstacles(obstacles) {}
 
+    const Field_Dimensions& fieldDimensions() const { return _fieldDimensions; }
+
     Geometry2d::Point randomState() const {
-        double x = _fieldDimensions.FloorWidth() * (drand48() - 0.5f);
-        double y = _fieldDimensions.FloorLength() * drand48() -
+        // drand48() shares one unsynchronized generator between all threads,
+        // which isn't safe when robots are planned in parallel.
+        thread_local std::mt19937 generator(std::random_device{}());
+        std::uniform_real_distribution<double> unit(0, 1);
+
+        double x = _fieldDimensions.FloorWidth() * (unit(generator) - 0.5f);
+        double y = _fieldDimensions.FloorLength() * unit(generator) -
                    _fieldDimensions.Border();
         return Geometry2d::Point(x, y);
     }
@@ -53,9 +66,9 @@ public:
         // Ensure that @to doesn't hit any obstacles that @from doesn't. This
         // allows the RRT to start inside an obstacle, but prevents it from
         // entering a new obstacle.
-        for (const auto& shape : _obstacles.shapes()) {
-            if (shape->hit(Geometry2d::Segment(from, to)) && !shape->hit(from))
-                return false;
+        for (const Geometry2d::Shape* shape :
+             _obstacles.hitSet(Geometry2d::Segment(from, to))) {
+            if (!shape->hit(from)) return false;
         }
         return true;
     }
@@ -0,0 +1,241 @@
+#include "SpaceTimeGrid.hpp"
+#include "Path.hpp"
+
+#include <Constants.hpp>
+#include <Field_Dimensions.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Geometry2d;
+
+namespace Planning {
+
+namespace {
+
+// About a robot's diameter per cell and a few robot lengths of travel per
+// time bucket, so a path only marks a few cells in each bucket
+constexpr double CellSize = 0.5;
+const RJ::Seconds BucketDuration = 100ms;
+
+// Number of buckets before the last one, which holds everything after them
+constexpr int TimedBuckets = 50;
+
+// How far apart paths are sampled.  Positions between samples are assumed to
+// be within one step of them at the fastest speed seen nearby, which holds
+// unless the speed changes a lot within a step.
+const RJ::Seconds SampleStep = 50ms;
+
+// Added to that distance for speeding up within a step.  Accelerating at a
+// for a step only adds 0.5 * a * SampleStep^2, which is under 1.5 cm even at
+// 10 m/s^2, several times what a robot can do.
+constexpr double SampleSlack = 0.05;
+
+// Spans in the last bucket longer than this get every cell instead of being
+// sampled
+const RJ::Seconds MaxSampledSpan = 10s;
+
+struct Sample {
+    Point pos;
+    double speed;
+};
+
+// Where @path is at @time, like ConstPathIterator, but staying at the start
+// of the path before it starts
+Sample sampleAt(const Path& path, RJ::Time time) {
+    const RJ::Seconds timeIntoPath =
+        std::max<RJ::Seconds>(time - path.startTime(), 0ms);
+    std::optional<RobotInstant> instant = path.evaluate(timeIntoPath);
+    const MotionInstant motion = instant ? instant->motion : path.end().motion;
+    return {motion.pos, motion.vel.mag()};
+}
+
+// When @path ends, or @limit if that's sooner, since some paths never end.
+// Path::pathsIntersect() goes by the unslowed duration and a slowed path
+// keeps moving after that, so this takes the later of the two.
+RJ::Time endTime(const Path& path, RJ::Time limit) {
+    const RJ::Seconds duration =
+        std::max(path.getDuration(), path.getSlowedDuration());
+    return path.startTime() +
+           std::min(duration, RJ::Seconds(limit - path.startTime()));
+}
+
+}  // namespace
+
+void SpaceTimeGrid::reset(RJ::Time start) {
+    // Cover the floor, like BiRRT
+    const Field_Dimensions& dims = Field_Dimensions::Current_Dimensions;
+    _start = start;
+    _min = Point(-dims.FloorWidth() / 2, -dims.Border());
+    _cols = std::max(1, int(std::ceil(dims.FloorWidth() / CellSize)));
+    _rows = std::max(1, int(std::ceil(dims.FloorLength() / CellSize)));
+    _cells.assign((TimedBuckets + 1) * _cols * _rows, 0);
+    _obstacles.clear();
+}
+
+RJ::Time SpaceTimeGrid::endLimit() const {
+    return _start + BucketDuration * TimedBuckets + MaxSampledSpan * 2;
+}
+
+int SpaceTimeGrid::bucketAt(RJ::Time time) const {
+    const double buckets = RJ::Seconds(time - _start) / BucketDuration;
+    return std::min(int(buckets), TimedBuckets);
+}
+
+SpaceTimeGrid::CellRange SpaceTimeGrid::cellsNear(Point min, Point max,
+                                                  double inflate) const {
+    auto column = [&](double x) {
+        const int col = std::floor((x - _min.x()) / CellSize);
+        return std::min(std::max(col, 0), _cols - 1);
+    };
+    auto row = [&](double y) {
+        const int row = std::floor((y - _min.y()) / CellSize);
+        return std::min(std::max(row, 0), _rows - 1);
+    };
+    return {column(min.x() - inflate), row(min.y() - inflate),
+            column(max.x() + inflate), row(max.y() + inflate)};
+}
+
+template <typename F>
+void SpaceTimeGrid::forEachSpan(const Path& path, RJ::Time from, RJ::Time to,
+                                double inflate, F&& f) const {
+    // Each span starts with the last sample of the one before it
+    Sample sample = sampleAt(path, from);
+    for (int bucket = bucketAt(from); from <= to; bucket++) {
+        RJ::Time spanEnd = to;
+        if (bucket < TimedBuckets) {
+            spanEnd = std::min(to, _start + BucketDuration * (bucket + 1));
+        } else if (to - from > MaxSampledSpan) {
+            f(bucket, CellRange{0, 0, _cols - 1, _rows - 1});
+            return;
+        }
+
+        Point min = sample.pos;
+        Point max = sample.pos;
+        double speed = sample.speed;
+        for (RJ::Time t = from; t < spanEnd;) {
+            const RJ::Time next = std::min(t + SampleStep, spanEnd);
+            const Point prev = sample.pos;
+            sample = sampleAt(path, next);
+            min = Point(std::min(min.x(), sample.pos.x()),
+                        std::min(min.y(), sample.pos.y()));
+            max = Point(std::max(max.x(), sample.pos.x()),
+                        std::max(max.y(), sample.pos.y()));
+
+            // A path's velocity doesn't have to match how its position
+            // changes, so this goes by both
+            const double moved =
+                prev.distTo(sample.pos) / RJ::Seconds(next - t).count();
+            speed = std::max({speed, sample.speed, moved});
+            t = next;
+        }
+        f(bucket, cellsNear(min, max,
+                            inflate + speed * SampleStep.count() +
+                                SampleSlack));
+
+        if (spanEnd >= to) {
+            return;
+        }
+        from = spanEnd;
+    }
+}
+
+void SpaceTimeGrid::add(const DynamicObstacle& obstacle) {
+    const uint64_t obstacleBit = bit(_obstacles.size());
+    _obstacles.push_back(obstacle);
+    if (!obstacleBit) {
+        return;
+    }
+
+    auto mark = [&](int bucket, const CellRange& cells) {
+        for (int row = cells.minRow; row <= cells.maxRow; row++) {
+            for (int col = cells.minCol; col <= cells.maxCol; col++) {
+                cell(bucket, col, row) |= obstacleBit;
+            }
+        }
+    };
+
+    const double inflate = obstacle.getRadius() + Robot_Radius;
+    const Path* path = obstacle.getPath();
+    if (!path) {
+        const Point center = obstacle.getStaticObstacle()->center;
+        const CellRange cells = cellsNear(center, center, inflate);
+        for (int bucket = 0; bucket <= TimedBuckets; bucket++) {
+            mark(bucket, cells);
+        }
+        return;
+    }
+
+    const RJ::Time pathEnd = std::max(endTime(*path, endLimit()), _start);
+    forEachSpan(*path, _start, pathEnd, inflate, mark);
+
+    // After that, the obstacle stays at the end of its path
+    const Point end = path->end().motion.pos;
+    const CellRange endCells = cellsNear(end, end, inflate);
+    for (int bucket = bucketAt(pathEnd) + 1; bucket <= TimedBuckets;
+         bucket++) {
+        mark(bucket, endCells);
+    }
+}
+
+bool SpaceTimeGrid::hit(uint64_t candidates, Point pos, RJ::Time time) const {
+    for (size_t i = 0; i < _obstacles.size(); i++) {
+        if (!(candidates & bit(i)) && indexed()) {
+            continue;
+        }
+
+        const DynamicObstacle& obs = _obstacles[i];
+        const Point obsPos = obs.hasPath()
+                                 ? sampleAt(*obs.getPath(), time).pos
+                                 : obs.getStaticObstacle()->center;
+        if (pos.distTo(obsPos) < obs.getRadius() + Robot_Radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SpaceTimeGrid::hit(Point pos, RJ::Time time) const {
+    uint64_t candidates = ~uint64_t(0);
+    if (time >= _start) {
+        const CellRange cells = cellsNear(pos, pos, 0);
+        candidates = cell(bucketAt(time), cells.minCol, cells.minRow);
+    }
+    return hit(candidates, pos, time);
+}
+
+bool SpaceTimeGrid::pathsIntersect(const Path& path, RJ::Time startTime,
+                                   Point* hitLocation,
+                                   RJ::Seconds* hitTime) const {
+    // Anything before the grid starts could hit anything
+    if (startTime < _start || !indexed()) {
+        return path.pathsIntersect(_obstacles, startTime, hitLocation,
+                                   hitTime);
+    }
+
+    uint64_t candidates = 0;
+    auto collect = [&](int bucket, const CellRange& cells) {
+        for (int row = cells.minRow; row <= cells.maxRow; row++) {
+            for (int col = cells.minCol; col <= cells.maxCol; col++) {
+                candidates |= cell(bucket, col, row);
+            }
+        }
+    };
+
+    // The exact check covers the path from the start time to its end
+    const RJ::Time to = std::max(endTime(path, endLimit()), startTime);
+    forEachSpan(path, startTime, to, 0, collect);
+    if (!candidates) {
+        return false;
+    }
+
+    std::vector<DynamicObstacle> nearby;
+    for (size_t i = 0; i < _obstacles.size(); i++) {
+        if (candidates & bit(i)) {
+            nearby.push_back(_obstacles[i]);
+        }
+    }
+    return path.pathsIntersect(nearby, startTime, hitLocation, hitTime);
+}
+
+}  // namespace Planning
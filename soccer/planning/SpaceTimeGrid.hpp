@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Geometry2d/Point.hpp>
+#include <time.hpp>
+#include "DynamicObstacle.hpp"
+
+namespace Planning {
+
+class Path;
+
+/**
+ * @brief Where a set of moving obstacles can be over the next few seconds, for
+ * fast collision checks against all of them.
+ *
+ * @details The field is split into coarse cells, and time into buckets
+ * starting at the time passed to reset().  Each cell of each bucket has a bit
+ * for every obstacle that might be within hitting distance of it during the
+ * bucket.  A check only looks at the obstacles whose bits are set along the
+ * way, so checking against the paths of every other robot costs about the
+ * same as checking against the one or two that are actually nearby.
+ *
+ * The last bucket holds everything after the others.  Checks before the
+ * grid's start time, or with more than 64 obstacles, look at every obstacle.
+ *
+ * Paths are only sampled every so often when they're added, and the cells
+ * between samples are found from the fastest speed seen nearby plus a few
+ * centimetres of slack for speeding up in between.  That covers any
+ * acceleration a robot is capable of, so for robots' paths the grid finds
+ * every hit that checking against all of the obstacles would.  A path that
+ * jumps further than that between samples can still be missed.
+ *
+ * The grid keeps pointers to the obstacles' paths, which must stay around
+ * until the next reset().  Checks don't modify the grid, so they can run on
+ * several threads as long as nothing is being added.
+ */
+class SpaceTimeGrid {
+public:
+    /// Clears the grid and starts its first time bucket at @start.  The grid
+    /// covers the current field dimensions.
+    void reset(RJ::Time start);
+
+    /// Adds an obstacle, along its path if it has one
+    void add(const DynamicObstacle& obstacle);
+
+    /// The obstacles that have been added since the last reset()
+    const std::vector<DynamicObstacle>& obstacles() const {
+        return _obstacles;
+    }
+
+    /// Whether a robot at @pos at @time would hit an obstacle
+    bool hit(Geometry2d::Point pos, RJ::Time time) const;
+
+    /**
+     * Checks @path for collisions with the obstacles from @startTime on, like
+     * path.pathsIntersect(obstacles(), ...).  It can miss a hit by an
+     * obstacle whose path jumps between samples, as described above.
+     */
+    bool pathsIntersect(const Path& path, RJ::Time startTime,
+                        Geometry2d::Point* hitLocation,
+                        RJ::Seconds* hitTime) const;
+
+private:
+    /// A range of cells, inclusive at both ends
+    struct CellRange {
+        int minCol, minRow, maxCol, maxRow;
+    };
+
+    /// Bit for obstacle @index, or zero if it's past the ones that fit
+    static uint64_t bit(size_t index) {
+        return index < 64 ? uint64_t(1) << index : 0;
+    }
+
+    /// Whether every obstacle has a bit
+    bool indexed() const { return _obstacles.size() <= 64; }
+
+    int bucketAt(RJ::Time time) const;
+
+    /// A time far enough into the last bucket that any span reaching it gets
+    /// every cell
+    RJ::Time endLimit() const;
+
+    /// Cells within @inflate of the box from @min to @max
+    CellRange cellsNear(Geometry2d::Point min, Geometry2d::Point max,
+                        double inflate) const;
+
+    uint64_t& cell(int bucket, int col, int row) {
+        return _cells[(bucket * _rows + row) * _cols + col];
+    }
+    uint64_t cell(int bucket, int col, int row) const {
+        return _cells[(bucket * _rows + row) * _cols + col];
+    }
+
+    /**
+     * Calls @f(bucket, cells) with the cells @path can be within @inflate of
+     * during each bucket from @from to @to.  Spans that can't be narrowed
+     * down, like the rest of a path that never ends, get all of the cells.
+     */
+    template <typename F>
+    void forEachSpan(const Path& path, RJ::Time from, RJ::Time to,
+                     double inflate, F&& f) const;
+
+    /// Whether some obstacle in @candidates hits @pos at @time
+    bool hit(uint64_t candidates, Geometry2d::Point pos, RJ::Time time) const;
+
+    RJ::Time _start;
+    Geometry2d::Point _min;
+    int _cols = 0;
+    int _rows = 0;
+
+    // Bucket b, row r, column c is _cells[(b * _rows + r) * _cols + c]
+    std::vector<uint64_t> _cells;
+
+    std::vector<DynamicObstacle> _obstacles;
+};
+
+}  // namespace Planning
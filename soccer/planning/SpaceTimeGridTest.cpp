@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <Constants.hpp>
+#include <planning/InterpolatedPath.hpp>
+#include <planning/SpaceTimeGrid.hpp>
+
+#include <random>
+
+using namespace std;
+using namespace Geometry2d;
+
+namespace Planning {
+
+namespace {
+
+/// A robot wandering around the field for a few seconds, changing its
+/// velocity a little at a time like a real path does
+unique_ptr<InterpolatedPath> wanderingPath(mt19937& gen, RJ::Time startTime) {
+    uniform_real_distribution<double> x(-3, 3);
+    uniform_real_distribution<double> y(0, 9);
+    uniform_real_distribution<double> accel(-6, 6);
+    uniform_real_distribution<double> dt(0.02, 0.06);
+    uniform_int_distribution<int> count(2, 120);
+
+    auto path = make_unique<InterpolatedPath>();
+    Point p(x(gen), y(gen));
+    Point v;
+    RJ::Seconds t = 0s;
+    for (int i = count(gen); i > 0; i--) {
+        path->waypoints.emplace_back(MotionInstant(p, v), t);
+        const RJ::Seconds step(dt(gen));
+        p += v * step.count();
+        v += Point(accel(gen), accel(gen)) * step.count();
+        if (v.mag() > 3) {
+            v = v.normalized(3);
+        }
+        t += step;
+    }
+    path->setStartTime(startTime);
+    return path;
+}
+
+}  // namespace
+
+// These paths speed up about as hard as a robot could, which the grid's slack
+// covers, so it shouldn't miss any hits
+TEST(SpaceTimeGrid, matchesPathsIntersect) {
+    mt19937 gen(1);
+    uniform_real_distribution<double> offset(-0.2, 2);
+    const RJ::Time now = RJ::now();
+
+    vector<unique_ptr<InterpolatedPath>> paths;
+    vector<DynamicObstacle> obstacles;
+    for (int i = 0; i < 11; i++) {
+        paths.push_back(wanderingPath(gen, now));
+        obstacles.emplace_back(paths.back().get(), Robot_Radius);
+    }
+    obstacles.emplace_back(Point(0, 4.5), 0.5);
+
+    SpaceTimeGrid grid;
+    grid.reset(now);
+    for (const DynamicObstacle& obs : obstacles) {
+        grid.add(obs);
+    }
+    ASSERT_EQ(obstacles.size(), grid.obstacles().size());
+
+    int hits = 0;
+    for (int i = 0; i < 500; i++) {
+        unique_ptr<InterpolatedPath> path = wanderingPath(gen, now);
+        const RJ::Time startTime = now + RJ::Seconds(offset(gen));
+
+        // Slowed paths take the sampled check
+        if (i % 4 == 0) {
+            path->slow(0.5);
+        }
+
+        Point expectedLocation, hitLocation;
+        RJ::Seconds expectedTime, hitTime;
+        const bool expected = path->pathsIntersect(
+            obstacles, startTime, &expectedLocation, &expectedTime);
+        ASSERT_EQ(expected, grid.pathsIntersect(*path, startTime, &hitLocation,
+                                                &hitTime));
+        if (expected) {
+            hits++;
+            EXPECT_EQ(expectedTime.count(), hitTime.count());
+            EXPECT_EQ(expectedLocation, hitLocation);
+        }
+    }
+    // Both cases are covered
+    EXPECT_GT(hits, 50);
+    EXPECT_LT(hits, 450);
+}
+
+TEST(SpaceTimeGrid, hit) {
+    mt19937 gen(2);
+    uniform_real_distribution<double> x(-3.5, 3.5);
+    uniform_real_distribution<double> y(-0.5, 9.5);
+    uniform_real_distribution<double> offset(-0.2, 8);
+    const RJ::Time now = RJ::now();
+
+    vector<unique_ptr<InterpolatedPath>> paths;
+    SpaceTimeGrid grid;
+    grid.reset(now);
+    for (int i = 0; i < 11; i++) {
+        paths.push_back(wanderingPath(gen, now));
+        grid.add(DynamicObstacle(paths.back().get(), Robot_Radius));
+    }
+
+    int hits = 0;
+    for (int i = 0; i < 5000; i++) {
+        const Point pos(x(gen), y(gen));
+        const RJ::Time time = now + RJ::Seconds(offset(gen));
+
+        bool expected = false;
+        for (const auto& path : paths) {
+            const RJ::Seconds timeIntoPath =
+                std::max<RJ::Seconds>(time - path->startTime(), 0s);
+            auto instant = path->evaluate(timeIntoPath);
+            const Point obsPos =
+                instant ? instant->motion.pos : path->end().motion.pos;
+            expected |= pos.distTo(obsPos) < 2 * Robot_Radius;
+        }
+        ASSERT_EQ(expected, grid.hit(pos, time));
+        hits += expected;
+    }
+    EXPECT_GT(hits, 0);
+}
+
+TEST(SpaceTimeGrid, reset) {
+    const RJ::Time now = RJ::now();
+    InterpolatedPath path;
+    path.waypoints.emplace_back(MotionInstant(Point(0, 0), Point(0, 2)), 0s);
+    path.waypoints.emplace_back(MotionInstant(Point(0, 1), Point(0, 2)), 0.5s);
+    path.waypoints.emplace_back(MotionInstant(Point(0, 2), Point(0, 2)), 1s);
+    path.setStartTime(now);
+
+    SpaceTimeGrid grid;
+    grid.reset(now);
+    grid.add(DynamicObstacle(Point(0, 1.5), Robot_Radius));
+    EXPECT_TRUE(grid.pathsIntersect(path, now, nullptr, nullptr));
+    EXPECT_TRUE(grid.hit(Point(0, 1.5), now + 10s));
+
+    grid.reset(now);
+    EXPECT_TRUE(grid.obstacles().empty());
+    EXPECT_FALSE(grid.pathsIntersect(path, now, nullptr, nullptr));
+    EXPECT_FALSE(grid.hit(Point(0, 1.5), now));
+}
+
+}  // namespace Planning
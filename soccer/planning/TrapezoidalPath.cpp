@@ -39,22 +39,22 @@ std::optional<RobotInstant> TrapezoidalPath::eval(RJ::Seconds time) const {
 
 bool TrapezoidalPath::hit(const Geometry2d::ShapeSet& obstacles,
                           RJ::Seconds initialTime, RJ::Seconds* hitTime) const {
-    std::set<std::shared_ptr<Shape>> startHitSet = obstacles.hitSet(_startPos);
+    const ShapeSet::HitSet startHitSet = obstacles.hitSet(_startPos);
     for (RJ::Seconds t = initialTime; t < _duration; t += RJ::Seconds(0.1)) {
         auto instant = evaluate(t);
         if (instant) {
-            for (auto& shape : obstacles.shapes()) {
+            for (const Shape* shape :
+                 obstacles.hitSet(instant->motion.pos)) {
                 // If the shape is in the original hitSet, it is ignored
-                if (startHitSet.find(shape) != startHitSet.end()) {
+                if (std::find(startHitSet.begin(), startHitSet.end(), shape) !=
+                    startHitSet.end()) {
                     continue;
                 }
 
-                if (shape->hit(instant->motion.pos)) {
-                    if (hitTime) {
-                        *hitTime = t;
-                    }
-                    return true;
+                if (hitTime) {
+                    *hitTime = t;
                 }
+                return true;
             }
         }
     }
@@ -7,7 +7,8 @@
 
 #include "vision/util/VisionFilterConfig.hpp"
 
-VisionFilter::VisionFilter() {
+VisionFilter::VisionFilter()
+    : latestSnapshot(std::make_shared<const WorldSnapshot>()) {
     threadEnd.store(false, std::memory_order::memory_order_seq_cst);
     
     // Have to be careful so the entire initialization list
@@ -28,79 +29,120 @@ void VisionFilter::addFrames(const std::vector<CameraFrame>& frames) {
     frameBuffer.insert(frameBuffer.end(), frames.begin(), frames.end());
 }
 
+std::shared_ptr<const WorldSnapshot> VisionFilter::snapshot() const {
+    return std::atomic_load(&latestSnapshot);
+}
+
 void VisionFilter::fillBallState(SystemState& state) {
-    std::lock_guard<std::mutex> lock(worldLock);
-    const WorldBall& wb = world.getWorldBall();
+    std::shared_ptr<const WorldSnapshot> world = snapshot();
+    const WorldSnapshot::Ball& wb = world->ball;
 
-    if (wb.getIsValid()) {
+    if (wb.valid) {
         state.ball.valid = true;
-        state.ball.pos = wb.getPos();
-        state.ball.vel = wb.getVel();
-        state.ball.time = wb.getTime();
+        state.ball.pos = wb.pos;
+        state.ball.vel = wb.vel;
+        state.ball.posCov = wb.posCov;
+        state.ball.velCov = wb.velCov;
+        state.ball.time = wb.time;
     } else {
         state.ball.valid = false;
     }
 }
 
 void VisionFilter::fillRobotState(SystemState& state, bool usBlue) {
-    std::lock_guard<std::mutex> lock(worldLock);
-    const auto& ourWorldRobot = usBlue ? world.getRobotsBlue() : world.getRobotsYellow();
-    const auto& oppWorldRobot = usBlue ? world.getRobotsYellow() : world.getRobotsBlue();
+    std::shared_ptr<const WorldSnapshot> world = snapshot();
+    const auto& ourWorldRobot = usBlue ? world->robotsBlue : world->robotsYellow;
+    const auto& oppWorldRobot = usBlue ? world->robotsYellow : world->robotsBlue;
+
+    auto fill = [](RobotPose* robot, const WorldSnapshot::Robot& wr) {
+        robot->visible = wr.valid;
+        robot->velValid = wr.valid;
+
+        if (wr.valid) {
+            robot->pos = wr.pos;
+            robot->vel = wr.vel;
+            robot->angle = wr.theta;
+            robot->angleVel = wr.omega;
+            robot->posCov = wr.posCov;
+            robot->velCov = wr.velCov;
+            robot->time = wr.time;
+        }
+    };
 
     // Fill our robots
     for (int i = 0; i < Num_Shells; i++) {
-        OurRobot* robot = state.self.at(i);
-        const WorldRobot& wr = ourWorldRobot.at(i);
-
-        robot->visible = wr.getIsValid();
-        robot->velValid = wr.getIsValid();
-
-        if (wr.getIsValid()) {
-            robot->pos = wr.getPos();
-            robot->vel = wr.getVel();
-            robot->angle = wr.getTheta();
-            robot->angleVel = wr.getOmega();
-            robot->time = wr.getTime();
-        }
+        fill(state.self.at(i), ourWorldRobot.at(i));
     }
 
     // Fill opp robots
     for (int i = 0; i < Num_Shells; i++) {
-        OpponentRobot* robot = state.opp.at(i);
-        const WorldRobot& wr = oppWorldRobot.at(i);
-
-        robot->visible = wr.getIsValid();
-        robot->velValid = wr.getIsValid();
-
-        if (wr.getIsValid()) {
-            robot->pos = wr.getPos();
-            robot->vel = wr.getVel();
-            robot->angle = wr.getTheta();
-            robot->angleVel = wr.getOmega();
-            robot->time = wr.getTime();
-        }
+        fill(state.opp.at(i), oppWorldRobot.at(i));
     }
 }
 
+void VisionFilter::publishSnapshot(RJ::Time calcTime) {
+    auto next = std::make_shared<WorldSnapshot>();
+    next->version = std::atomic_load(&latestSnapshot)->version + 1;
+    next->calcTime = calcTime;
+
+    const WorldBall& wb = world.getWorldBall();
+    next->ball.valid = wb.getIsValid();
+    if (wb.getIsValid()) {
+        next->ball.pos = wb.getPos();
+        next->ball.vel = wb.getVel();
+        next->ball.posCov = wb.getPosCov();
+        next->ball.velCov = wb.getVelCov();
+        next->ball.time = wb.getTime();
+    }
+
+    auto copyRobots = [](const std::vector<WorldRobot>& from,
+                         std::array<WorldSnapshot::Robot, Num_Shells>& to) {
+        for (int i = 0; i < Num_Shells; i++) {
+            const WorldRobot& wr = from.at(i);
+            to.at(i).valid = wr.getIsValid();
+            if (wr.getIsValid()) {
+                to.at(i).pos = wr.getPos();
+                to.at(i).vel = wr.getVel();
+                to.at(i).theta = wr.getTheta();
+                to.at(i).omega = wr.getOmega();
+                to.at(i).posCov = wr.getPosCov();
+                to.at(i).velCov = wr.getVelCov();
+                to.at(i).time = wr.getTime();
+            }
+        }
+    };
+    copyRobots(world.getRobotsYellow(), next->robotsYellow);
+    copyRobots(world.getRobotsBlue(), next->robotsBlue);
+
+    std::atomic_store(&latestSnapshot,
+                      std::shared_ptr<const WorldSnapshot>(std::move(next)));
+}
+
 void VisionFilter::updateLoop() {
     while (!threadEnd.load(std::memory_order::memory_order_seq_cst)) {
         RJ::Time start = RJ::now();
 
         {
-            // Do update with whatever is in frame buffer
-            std::lock_guard<std::mutex> lock1(frameLock);
-            {
-                std::lock_guard<std::mutex> lock2(worldLock);
-
-                if (frameBuffer.size() > 0) {
-                    world.updateWithCameraFrame(RJ::now(), frameBuffer);
-                    frameBuffer.clear();
-                } else {
-                    world.updateWithoutCameraFrame(RJ::now());
-                }
-            }
+            // Take whatever is in the frame buffer.  The swap is all that
+            // happens under the lock so addFrames() never waits on an update.
+            std::lock_guard<std::mutex> lock(frameLock);
+            frameBuffer.swap(processingBuffer);
         }
 
+        // Do update with the frames we took
+        RJ::Time calcTime = RJ::now();
+        if (processingBuffer.size() > 0) {
+            world.updateWithCameraFrame(calcTime, processingBuffer);
+
+            // Keeps the capacity, so the buffers stop allocating once
+            // they've grown
+            processingBuffer.clear();
+        } else {
+            world.updateWithoutCameraFrame(calcTime);
+        }
+
+        publishSnapshot(calcTime);
+
         // Wait for the correct loop timings
         RJ::Seconds diff = RJ::now() - start;
         RJ::Seconds sleepLeft = RJ::Seconds(*VisionFilterConfig::vision_loop_dt) - diff;
@@ -1,15 +1,16 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
-#include <vector>
 #include <thread>
 
 #include <SystemState.hpp>
 
 #include "vision/camera/CameraFrame.hpp"
 #include "vision/camera/World.hpp"
+#include "vision/WorldSnapshot.hpp"
 
 /**
  * Uses a seperate thread to filter the vision measurements into
@@ -17,7 +18,11 @@
  *
  * Add vision frames directly into the filter call the fill states functions
  * to push the newest estimates directly into the system state.
- * 
+ *
+ * After every iteration the filter publishes its estimates as an immutable
+ * WorldSnapshot.  Readers pick up the latest snapshot through an atomic
+ * pointer, so they never wait on the filter.
+ *
  * Note: There may be a 1 frame delay between the measurements being added
  * and the measurements being included in the filter estimate.
  */
@@ -36,6 +41,11 @@ public:
      */
     void addFrames(const std::vector<CameraFrame>& frames);
 
+    /**
+     * @return The estimates from the latest filter iteration.  Never null.
+     */
+    std::shared_ptr<const WorldSnapshot> snapshot() const;
+
     /**
      * Fills system state with the ball pos/vel
      *
@@ -54,13 +64,29 @@ public:
 private:
     void updateLoop();
 
+    /**
+     * Copies the world's estimates into a new snapshot and publishes it
+     *
+     * @param calcTime Time of the iteration that just finished
+     */
+    void publishSnapshot(RJ::Time calcTime);
+
     std::thread worker;
 
-    std::mutex worldLock;
+    // Only used by the worker thread
     World world;
 
+    // Latest published estimates.  Only accessed with std::atomic_load and
+    // std::atomic_store.
+    std::shared_ptr<const WorldSnapshot> latestSnapshot;
+
     std::atomic_bool threadEnd;
 
+    // Frames added since the worker last took them
     std::mutex frameLock;
     std::vector<CameraFrame> frameBuffer;
+
+    // Frames being processed by the worker.  Swapped with frameBuffer each
+    // iteration.
+    std::vector<CameraFrame> processingBuffer;
 };
\ No newline at end of file
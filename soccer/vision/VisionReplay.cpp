@@ -0,0 +1,284 @@
+#include <Configuration.hpp>
+#include <Constants.hpp>
+#include <LogReader.hpp>
+#include <Utils.hpp>
+#include <protobuf/LogFrame.pb.h>
+
+#include "vision/camera/CameraFrame.hpp"
+#include "vision/camera/World.hpp"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Packet;
+using namespace std;
+
+void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [options...] <filename.log>\n", prog);
+    fprintf(stderr, "\t-c <file>:    specify the configuration file\n");
+    fprintf(stderr, "\t-o <file>:    write the tracked state as CSV\n");
+    fprintf(stderr,
+            "\t-realtime:    replay at the recorded rate instead of as fast "
+            "as possible\n");
+    exit(1);
+}
+
+/// Converts one detection frame the same way Processor::runModels does,
+/// without the team transform
+CameraFrame toCameraFrame(const SSL_DetectionFrame& det, RJ::Time logTime) {
+    // Packets are logged before Processor moves the capture time onto our
+    // clock, so do the same here using the time the frame was logged
+    RJ::Time time =
+        logTime - RJ::Seconds(max(0.0, det.t_sent() - det.t_capture()));
+
+    vector<CameraBall> balls;
+    balls.reserve(det.balls().size());
+    for (const SSL_DetectionBall& ball : det.balls()) {
+        balls.emplace_back(time,
+                           Geometry2d::Point(ball.x() / 1000, ball.y() / 1000));
+    }
+
+    auto robots = [&](const auto& detections) {
+        vector<CameraRobot> out;
+        out.reserve(detections.size());
+        for (const SSL_DetectionRobot& robot : detections) {
+            out.emplace_back(
+                time, Geometry2d::Point(robot.x() / 1000, robot.y() / 1000),
+                fixAngleRadians(robot.orientation()), robot.robot_id());
+        }
+        return out;
+    };
+
+    return CameraFrame(time, det.camera_id(), balls,
+                       robots(det.robots_yellow()), robots(det.robots_blue()));
+}
+
+/// Sum of squared distances from estimates to measurements, for the RMS
+/// error in the summary
+struct Residual {
+    double sumSq = 0;
+    int count = 0;
+
+    void add(double dist) {
+        sumSq += dist * dist;
+        count++;
+    }
+
+    double rms() const { return count > 0 ? sqrt(sumSq / count) : 0; }
+};
+
+void addRobotResiduals(const vector<WorldRobot>& estimates,
+                       const vector<CameraRobot>& measurements,
+                       Residual& residual) {
+    for (const CameraRobot& robot : measurements) {
+        const int id = robot.getRobotID();
+        if (id >= 0 && id < estimates.size() && estimates[id].getIsValid()) {
+            residual.add((estimates[id].getPos() - robot.getPos()).mag());
+        }
+    }
+}
+
+void writeRobots(ofstream& out, double t, const char* team,
+                 const vector<WorldRobot>& robots) {
+    for (const WorldRobot& robot : robots) {
+        if (robot.getIsValid()) {
+            out << t << ',' << team << ',' << robot.getRobotID() << ','
+                << robot.getPos().x() << ',' << robot.getPos().y() << ','
+                << robot.getTheta() << ',' << robot.getVel().x() << ','
+                << robot.getVel().y() << ',' << robot.getOmega() << '\n';
+        }
+    }
+}
+
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t i = min(sorted.size() - 1, size_t(p * sorted.size()));
+    return sorted[i];
+}
+
+/**
+ * Replays the raw vision packets from a log through the vision filter
+ *
+ * Each log frame holds the packets the processor received during one
+ * iteration, so World gets one update per log frame with the time the frame
+ * was recorded.  Everything is kept in ssl-vision coordinates (converted to
+ * meters) so the output doesn't depend on which team was running.
+ *
+ * Prints the update latency and throughput, along with how far the estimates
+ * are from the measurements, so filter changes can be compared on the same
+ * log for both speed and accuracy.  The tracked state can be written out with
+ * -o to diff the output of two versions directly.
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QString cfgFile;
+    string outFile;
+    string logFile;
+    bool realtime = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* var = argv[i];
+
+        if (strcmp(var, "--help") == 0) {
+            usage(argv[0]);
+        } else if (strcmp(var, "-c") == 0) {
+            if (i + 1 >= argc) {
+                printf("no config file specified after -c\n");
+                usage(argv[0]);
+            }
+            cfgFile = argv[++i];
+        } else if (strcmp(var, "-o") == 0) {
+            if (i + 1 >= argc) {
+                printf("no output file specified after -o\n");
+                usage(argv[0]);
+            }
+            outFile = argv[++i];
+        } else if (strcmp(var, "-realtime") == 0) {
+            realtime = true;
+        } else if (logFile.empty() && var[0] != '-') {
+            logFile = var;
+        } else {
+            printf("Not a valid flag: %s\n", argv[i]);
+            usage(argv[0]);
+        }
+    }
+
+    if (logFile.empty()) {
+        usage(argv[0]);
+    }
+
+    // Use the same config as the real field unless told otherwise
+    if (cfgFile.isNull()) {
+        cfgFile = ApplicationRunDirectory().filePath("soccer-real.cfg");
+    }
+
+    std::shared_ptr<Configuration> config =
+        Configuration::FromRegisteredConfigurables();
+    QString error;
+    if (!config->load(cfgFile, error)) {
+        fprintf(stderr, "Can't read configuration %s: %s\n",
+                cfgFile.toStdString().c_str(), error.toStdString().c_str());
+        return 1;
+    }
+
+    // Only one frame is decoded at a time
+    LogReader log(1);
+    if (!log.open(logFile)) {
+        return 1;
+    }
+
+    ofstream out;
+    if (!outFile.empty()) {
+        out.open(outFile);
+        if (!out) {
+            fprintf(stderr, "Can't write %s\n", outFile.c_str());
+            return 1;
+        }
+        out << "time,object,id,x,y,theta,vx,vy,omega\n";
+    }
+
+    World world;
+    vector<CameraFrame> frames;
+    vector<double> latencies;
+    latencies.reserve(log.size());
+    int numCameraFrames = 0;
+    Residual ballResidual;
+    Residual robotResidual;
+
+    const RJ::Time wallStart = RJ::now();
+    const uint64_t logStart = log.size() > 0 ? log.timestamp(0) : 0;
+
+    for (size_t i = 0; i < log.size(); i++) {
+        shared_ptr<LogFrame> frame = log.frame(i);
+        if (!frame) {
+            continue;
+        }
+
+        const RJ::Time logTime =
+            RJ::Time(chrono::microseconds(log.timestamp(i)));
+        if (realtime) {
+            this_thread::sleep_until(
+                wallStart + chrono::microseconds(log.timestamp(i) - logStart));
+        }
+
+        frames.clear();
+        for (const SSL_WrapperPacket& wrapper : frame->raw_vision()) {
+            if (wrapper.has_detection()) {
+                frames.push_back(toCameraFrame(wrapper.detection(), logTime));
+            }
+        }
+        numCameraFrames += frames.size();
+
+        const RJ::Time start = RJ::now();
+        if (!frames.empty()) {
+            world.updateWithCameraFrame(logTime, frames);
+        } else {
+            world.updateWithoutCameraFrame(logTime);
+        }
+        latencies.push_back(RJ::numSeconds(RJ::now() - start));
+
+        const WorldBall& ball = world.getWorldBall();
+        for (const CameraFrame& cameraFrame : frames) {
+            if (ball.getIsValid() && !cameraFrame.cameraBalls.empty()) {
+                double closest = numeric_limits<double>::infinity();
+                for (const CameraBall& measurement : cameraFrame.cameraBalls) {
+                    closest = min(
+                        closest, (ball.getPos() - measurement.getPos()).mag());
+                }
+                ballResidual.add(closest);
+            }
+            addRobotResiduals(world.getRobotsYellow(),
+                              cameraFrame.cameraRobotsYellow, robotResidual);
+            addRobotResiduals(world.getRobotsBlue(),
+                              cameraFrame.cameraRobotsBlue, robotResidual);
+        }
+
+        if (out.is_open()) {
+            const double t = (log.timestamp(i) - logStart) / 1e6;
+            if (ball.getIsValid()) {
+                out << t << ",ball,0," << ball.getPos().x() << ','
+                    << ball.getPos().y() << ",0," << ball.getVel().x() << ','
+                    << ball.getVel().y() << ",0\n";
+            }
+            writeRobots(out, t, "yellow", world.getRobotsYellow());
+            writeRobots(out, t, "blue", world.getRobotsBlue());
+        }
+    }
+
+    const double wallTime = RJ::numSeconds(RJ::now() - wallStart);
+    double updateTime = 0;
+    for (double latency : latencies) {
+        updateTime += latency;
+    }
+    sort(latencies.begin(), latencies.end());
+
+    printf("%s: %zu log frames, %d camera frames, %.1f s of play\n",
+           logFile.c_str(), log.size(), numCameraFrames,
+           log.size() > 0 ? (log.timestamp(log.size() - 1) - logStart) / 1e6
+                          : 0.0);
+    printf("Update latency (us): p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  "
+           "max %.1f\n",
+           percentile(latencies, 0.5) * 1e6, percentile(latencies, 0.9) * 1e6,
+           percentile(latencies, 0.99) * 1e6,
+           percentile(latencies, 0.999) * 1e6,
+           (latencies.empty() ? 0 : latencies.back()) * 1e6);
+    printf("Throughput: %.0f updates/s, %.0f camera frames/s (%.2f s wall)\n",
+           updateTime > 0 ? latencies.size() / updateTime : 0,
+           updateTime > 0 ? numCameraFrames / updateTime : 0, wallTime);
+    printf("Estimate to measurement RMS (m): ball %.4f (%d), robots %.4f (%d)\n",
+           ballResidual.rms(), ballResidual.count, robotResidual.rms(),
+           robotResidual.count);
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <Constants.hpp>
+#include <Geometry2d/Point.hpp>
+#include <Utils.hpp>
+
+/**
+ * Copy of the vision filter's estimates at the end of one filter iteration
+ *
+ * VisionFilter publishes a new snapshot every iteration and never changes it
+ * afterwards, so readers can hold on to one without locking.
+ */
+class WorldSnapshot {
+public:
+    class Ball {
+    public:
+        bool valid = false;
+        Geometry2d::Point pos;
+        Geometry2d::Point vel;
+        // Average position and velocity covariance of the filter
+        double posCov = 0;
+        double velCov = 0;
+        RJ::Time time;
+    };
+
+    class Robot {
+    public:
+        bool valid = false;
+        Geometry2d::Point pos;
+        Geometry2d::Point vel;
+        double theta = 0;
+        double omega = 0;
+        // Average position and velocity covariance of the filter
+        double posCov = 0;
+        double velCov = 0;
+        RJ::Time time;
+    };
+
+    // Incremented every filter iteration, starting at 1
+    uint64_t version = 0;
+
+    // Time of the filter iteration that produced this snapshot
+    RJ::Time calcTime;
+
+    Ball ball;
+    std::array<Robot, Num_Shells> robotsYellow;
+    std::array<Robot, Num_Shells> robotsBlue;
+};
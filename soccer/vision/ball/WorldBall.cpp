@@ -89,7 +89,7 @@ WorldBall::WorldBall(RJ::Time calcTime, std::list<KalmanBall> kalmanBalls)
     vel = velAvg;
     posCov = totalPosWeight / kalmanBalls.size();
     velCov = totalVelWeight / kalmanBalls.size();
-    ballComponents = kalmanBalls;
+    ballComponents = std::move(kalmanBalls);
 }
 
 bool WorldBall::getIsValid() const {
@@ -21,13 +21,43 @@ void Camera::createConfiguration(Configuration* cfg) {
     max_num_kalman_robots = new ConfigInt(cfg, "VisionFilter/Camera/max_num_kalman_robots", 10);
 }
 
-Camera::Camera() : isValid(false) {}
+Camera::Camera() : isValid(false), bestKalmanBall(nullptr) {}
 
 Camera::Camera(int cameraID)
     : isValid(true),
       cameraID(cameraID),
       kalmanRobotYellowList(Num_Shells),
-      kalmanRobotBlueList(Num_Shells) {}
+      kalmanRobotBlueList(Num_Shells),
+      bestKalmanBall(nullptr),
+      bestKalmanRobotYellow(Num_Shells, nullptr),
+      bestKalmanRobotBlue(Num_Shells, nullptr) {}
+
+Camera::Camera(const Camera& other)
+    : isValid(other.isValid),
+      cameraID(other.cameraID),
+      kalmanBallList(other.kalmanBallList),
+      kalmanRobotYellowList(other.kalmanRobotYellowList),
+      kalmanRobotBlueList(other.kalmanRobotBlueList),
+      bestKalmanBall(nullptr),
+      bestKalmanRobotYellow(other.bestKalmanRobotYellow.size(), nullptr),
+      bestKalmanRobotBlue(other.bestKalmanRobotBlue.size(), nullptr) {
+    updateBestFilters();
+}
+
+Camera& Camera::operator=(const Camera& other) {
+    if (this != &other) {
+        isValid = other.isValid;
+        cameraID = other.cameraID;
+        kalmanBallList = other.kalmanBallList;
+        kalmanRobotYellowList = other.kalmanRobotYellowList;
+        kalmanRobotBlueList = other.kalmanRobotBlueList;
+        bestKalmanRobotYellow.assign(other.bestKalmanRobotYellow.size(), nullptr);
+        bestKalmanRobotBlue.assign(other.bestKalmanRobotBlue.size(), nullptr);
+        updateBestFilters();
+    }
+
+    return *this;
+}
 
 bool Camera::getIsValid() const {
     return isValid;
@@ -60,6 +90,8 @@ void Camera::updateWithFrame(RJ::Time calcTime,
     updateBalls(calcTime, ballList, previousWorldBall);
     updateRobots(calcTime, yellowRobotList, blueRobotList,
                  previousYellowWorldRobots, previousBlueWorldRobots);
+
+    updateBestFilters();
 }
 
 void Camera::updateWithoutFrame(RJ::Time calcTime) {
@@ -81,6 +113,8 @@ void Camera::updateWithoutFrame(RJ::Time calcTime) {
             robot.predict(calcTime);
         }
     }
+
+    updateBestFilters();
 }
 
 void Camera::updateBalls(RJ::Time calcTime,
@@ -370,6 +404,31 @@ void Camera::predictAllRobots(RJ::Time calcTime, std::vector<std::list<KalmanRob
     }
 }
 
+void Camera::updateBestFilters() {
+    // Ties go to the older filter
+    bestKalmanBall = nullptr;
+    for (const KalmanBall& b : kalmanBallList) {
+        if (!bestKalmanBall || b.getHealth() > bestKalmanBall->getHealth()) {
+            bestKalmanBall = &b;
+        }
+    }
+
+    auto findBest = [](const std::vector<std::list<KalmanRobot>>& robotListList,
+                       std::vector<const KalmanRobot*>& best) {
+        for (int i = 0; i < best.size(); i++) {
+            best.at(i) = nullptr;
+            for (const KalmanRobot& r : robotListList.at(i)) {
+                if (!best.at(i) || r.getHealth() > best.at(i)->getHealth()) {
+                    best.at(i) = &r;
+                }
+            }
+        }
+    };
+
+    findBest(kalmanRobotYellowList, bestKalmanRobotYellow);
+    findBest(kalmanRobotBlueList, bestKalmanRobotBlue);
+}
+
 const std::list<KalmanBall>& Camera::getKalmanBalls() const {
     return kalmanBallList;
 }
@@ -380,4 +439,16 @@ const std::vector<std::list<KalmanRobot>>& Camera::getKalmanRobotsYellow() const
 
 const std::vector<std::list<KalmanRobot>>& Camera::getKalmanRobotsBlue() const {
     return kalmanRobotBlueList;
+}
+
+const KalmanBall* Camera::getBestKalmanBall() const {
+    return bestKalmanBall;
+}
+
+const std::vector<const KalmanRobot*>& Camera::getBestKalmanRobotsYellow() const {
+    return bestKalmanRobotYellow;
+}
+
+const std::vector<const KalmanRobot*>& Camera::getBestKalmanRobotsBlue() const {
+    return bestKalmanRobotBlue;
 }
\ No newline at end of file
@@ -33,6 +33,14 @@ public:
      */
     Camera(int cameraID);
 
+    /**
+     * Copies keep track of their own best filters
+     */
+    Camera(const Camera& other);
+    Camera& operator=(const Camera& other);
+    Camera(Camera&& other) = default;
+    Camera& operator=(Camera&& other) = default;
+
     /**
      * Returns whether this camera is valid and initialized correctly
      */
@@ -92,6 +100,25 @@ public:
      */
     const std::vector<std::list<KalmanRobot>>& getKalmanRobotsBlue() const;
 
+    /**
+     * @return The healthiest kalman ball, or nullptr if there are none
+     *
+     * Kept up to date by the update functions so it doesn't need a search
+     */
+    const KalmanBall* getBestKalmanBall() const;
+
+    /**
+     * @return The healthiest yellow kalman robot for each robot id, or
+     *         nullptr for ids without any
+     */
+    const std::vector<const KalmanRobot*>& getBestKalmanRobotsYellow() const;
+
+    /**
+     * @return The healthiest blue kalman robot for each robot id, or
+     *         nullptr for ids without any
+     */
+    const std::vector<const KalmanRobot*>& getBestKalmanRobotsBlue() const;
+
     static void createConfiguration(Configuration* cfg);
 
 private:
@@ -195,6 +222,13 @@ private:
      */
     void predictAllRobots(RJ::Time calcTime, std::vector<std::list<KalmanRobot>>& robotListList);
 
+    /**
+     * Finds the healthiest filter for each object
+     *
+     * Call whenever the filters have been updated or the lists changed
+     */
+    void updateBestFilters();
+
     bool isValid;
 
     int cameraID;
@@ -202,6 +236,11 @@ private:
     std::vector<std::list<KalmanRobot>> kalmanRobotYellowList;
     std::vector<std::list<KalmanRobot>> kalmanRobotBlueList;
 
+    // Point into the lists above, which never move their elements
+    const KalmanBall* bestKalmanBall;
+    std::vector<const KalmanRobot*> bestKalmanRobotYellow;
+    std::vector<const KalmanRobot*> bestKalmanRobotBlue;
+
     // The cutoff radius for when to associate measurements to kalman objects
     static ConfigDouble* MHKF_radius_cutoff;
     // Whether to use MHKF or AKF
@@ -9,12 +9,17 @@ REGISTER_CONFIGURABLE(World)
 ConfigDouble* World::fast_kick_timeout;
 ConfigDouble* World::slow_kick_timeout;
 ConfigDouble* World::same_kick_timeout;
+ConfigBool* World::parallel_camera_update;
+ConfigInt* World::num_camera_threads;
 
 void World::createConfiguration(Configuration* cfg) {
     // Note: slow kick timeout should be smaller than fast kick timeout
     fast_kick_timeout = new ConfigDouble(cfg, "VisionFilter/Kick/Detector/fast_kick_timeout", 1);
     slow_kick_timeout = new ConfigDouble(cfg, "VisionFilter/Kick/Detector/slow_kick_timeout", 0.5);
     same_kick_timeout = new ConfigDouble(cfg, "VisionFilter/Kick/Detector/same_kick_timeout", 0.05);
+
+    parallel_camera_update = new ConfigBool(cfg, "VisionFilter/Threading/parallel", true);
+    num_camera_threads = new ConfigInt(cfg, "VisionFilter/Threading/num_threads", 4);
 }
 
 World::World()
@@ -23,137 +28,171 @@ World::World()
       robotsBlue(Num_Shells, WorldRobot()) {}
 
 void World::updateWithCameraFrame(RJ::Time calcTime, const std::vector<CameraFrame>& newFrames) {
-    calcBallBounce();
-
-    std::vector<bool> cameraUpdated(*VisionFilterConfig::max_num_cameras, false);
+    // Cameras that existed before these frames get their ball bounces
+    // processed.  New ones don't have any balls yet.
+    std::vector<bool> cameraExisted(cameras.size());
+    for (int i = 0; i < cameras.size(); i++) {
+        cameraExisted.at(i) = cameras.at(i).getIsValid();
+    }
 
     // TODO: Take only the newest frame if 2 come in for the same camera
 
+    // Group the frames by camera, keeping their order
+    std::vector<std::vector<const CameraFrame*>> cameraFrames(cameras.size());
     for (const CameraFrame& frame : newFrames) {
         // Make sure camera from frame is created, if not, make it
         if (!cameras.at(frame.cameraID).getIsValid()) {
             cameras.at(frame.cameraID) = Camera(frame.cameraID);
         }
 
-        // Take the non-sorted list from the frame and make a list for the cameras
-        std::vector<std::list<CameraRobot>> yellowTeam(Num_Shells);
-        std::vector<std::list<CameraRobot>> blueTeam(Num_Shells);
+        cameraFrames.at(frame.cameraID).push_back(&frame);
+    }
 
-        for (const CameraRobot& robot : frame.cameraRobotsYellow) {
-            yellowTeam.at(robot.getRobotID()).push_back(robot);
+    std::vector<int> cameraIDs;
+    for (int i = 0; i < cameras.size(); i++) {
+        if (cameras.at(i).getIsValid()) {
+            cameraIDs.push_back(i);
         }
+    }
+
+    updateCameras(cameraIDs, [&](int cameraID) {
+        Camera& camera = cameras.at(cameraID);
 
-        for (const CameraRobot& robot : frame.cameraRobotsBlue) {
-            blueTeam.at(robot.getRobotID()).push_back(robot);
+        if (cameraExisted.at(cameraID)) {
+            camera.processBallBounce(robotsYellow, robotsBlue);
         }
 
-        cameras.at(frame.cameraID).updateWithFrame(calcTime,
-                                                   frame.cameraBalls,
-                                                   yellowTeam,
-                                                   blueTeam,
-                                                   ball,
-                                                   robotsYellow,
-                                                   robotsBlue);
+        if (cameraFrames.at(cameraID).empty()) {
+            camera.updateWithoutFrame(calcTime);
+            return;
+        }
 
-        cameraUpdated.at(frame.cameraID) = true;
-    }
+        for (const CameraFrame* frame : cameraFrames.at(cameraID)) {
+            // Take the non-sorted list from the frame and make a list for the cameras
+            std::vector<std::list<CameraRobot>> yellowTeam(Num_Shells);
+            std::vector<std::list<CameraRobot>> blueTeam(Num_Shells);
 
-    for (int i = 0; i < cameras.size(); i++) {
-        if (!cameraUpdated.at(i) && cameras.at(i).getIsValid()) {
-            cameras.at(i).updateWithoutFrame(calcTime);
+            for (const CameraRobot& robot : frame->cameraRobotsYellow) {
+                yellowTeam.at(robot.getRobotID()).push_back(robot);
+            }
+
+            for (const CameraRobot& robot : frame->cameraRobotsBlue) {
+                blueTeam.at(robot.getRobotID()).push_back(robot);
+            }
+
+            camera.updateWithFrame(calcTime,
+                                   frame->cameraBalls,
+                                   yellowTeam,
+                                   blueTeam,
+                                   ball,
+                                   robotsYellow,
+                                   robotsBlue);
         }
-    }
+    });
 
     updateWorldObjects(calcTime);
     detectKicks(calcTime);
 }
 
 void World::updateWithoutCameraFrame(RJ::Time calcTime) {
-    calcBallBounce();
-
-    for (Camera& camera : cameras) {
-        if (camera.getIsValid()) {
-            camera.updateWithoutFrame(calcTime);
+    std::vector<int> cameraIDs;
+    for (int i = 0; i < cameras.size(); i++) {
+        if (cameras.at(i).getIsValid()) {
+            cameraIDs.push_back(i);
         }
     }
 
+    updateCameras(cameraIDs, [&](int cameraID) {
+        Camera& camera = cameras.at(cameraID);
+        camera.processBallBounce(robotsYellow, robotsBlue);
+        camera.updateWithoutFrame(calcTime);
+    });
+
     updateWorldObjects(calcTime);
     detectKicks(calcTime);
 }
 
-void World::calcBallBounce() {
-    for (Camera& camera : cameras) {
-        if (camera.getIsValid()) {
-            camera.processBallBounce(robotsYellow, robotsBlue);
+template <typename F>
+void World::updateCameras(const std::vector<int>& cameraIDs, F&& update) {
+    if (!*parallel_camera_update || cameraIDs.size() < 2) {
+        for (int cameraID : cameraIDs) {
+            update(cameraID);
         }
+        return;
+    }
+
+    const size_t numThreads = std::max(num_camera_threads->value(), 1);
+    if (!threadPool || threadPool->size() != numThreads) {
+        threadPool = std::make_unique<ThreadPool>(numThreads);
+    }
+
+    // Each camera only touches its own filters and reads the previous
+    // frame's world objects, which aren't changed until updateWorldObjects()
+    std::vector<std::future<void>> results;
+    results.reserve(cameraIDs.size());
+    for (int cameraID : cameraIDs) {
+        results.push_back(
+            threadPool->enqueue([&update, cameraID]() { update(cameraID); }));
+    }
+
+    // Wait for every camera before get() can rethrow, since the jobs
+    // reference this stack frame.
+    for (auto& result : results) {
+        result.wait();
+    }
+    for (auto& result : results) {
+        result.get();
     }
 }
 
 void World::updateWorldObjects(RJ::Time calcTime) {
-    // Fill robotsYellow/Blue with what robots we want and remove the rest
-    ball = WorldBall();
+    // Take best kalman filter from every camera and combine them.  The
+    // cameras keep track of their best filters, so this is just a lookup.
+    std::list<KalmanBall> kalmanBalls;
+    for (const Camera& camera : cameras) {
+        if (camera.getIsValid() && camera.getBestKalmanBall()) {
+            kalmanBalls.push_back(*camera.getBestKalmanBall());
+        }
+    }
+
+    // Only replace the invalid result if we have measurements on any camera
+    if (kalmanBalls.size() > 0) {
+        ball = WorldBall(calcTime, std::move(kalmanBalls));
+    } else {
+        ball = WorldBall();
+    }
 
-    std::fill(robotsYellow.begin(), robotsYellow.end(), WorldRobot());
-    std::fill(robotsBlue.begin(), robotsBlue.end(), WorldRobot());
+    for (int i = 0; i < robotsYellow.size(); i++) {
+        std::list<KalmanRobot> kalmanRobotsYellow;
+        std::list<KalmanRobot> kalmanRobotsBlue;
 
-    std::list<KalmanBall> kalmanBalls;
-    std::vector<std::list<KalmanRobot>> kalmanRobotsYellow(Num_Shells);
-    std::vector<std::list<KalmanRobot>> kalmanRobotsBlue(Num_Shells);
-
-    // Take best kalman filter from every camera and combine them
-    for (Camera& camera : cameras) {
-        if (camera.getIsValid()) {
-            std::list<KalmanBall> cameraBalls = camera.getKalmanBalls();
-            std::vector<std::list<KalmanRobot>> cameraRobotsYellow = camera.getKalmanRobotsYellow();
-            std::vector<std::list<KalmanRobot>> cameraRobotsBlue = camera.getKalmanRobotsBlue();
-
-            if (cameraBalls.size() > 0) {
-                // Sort by health of the kalman filter
-                cameraBalls.sort([](KalmanBall& a, KalmanBall& b) -> bool {
-                                    return a.getHealth() > b.getHealth();
-                                });
-
-                kalmanBalls.push_back(cameraBalls.front());
+        for (const Camera& camera : cameras) {
+            if (!camera.getIsValid()) {
+                continue;
             }
 
-            // Take the best kalman filter from the camera
-            for (int i = 0; i < cameraRobotsYellow.size(); i++) {
-                if (cameraRobotsYellow.at(i).size() > 0) {
-                    cameraRobotsYellow.at(i).sort([](KalmanRobot& a, KalmanRobot& b) -> bool {
-                                                         return a.getHealth() > b.getHealth();
-                                                     });
+            const KalmanRobot* bestYellow = camera.getBestKalmanRobotsYellow().at(i);
+            const KalmanRobot* bestBlue = camera.getBestKalmanRobotsBlue().at(i);
 
-                    kalmanRobotsYellow.at(i).push_back(cameraRobotsYellow.at(i).front());
-                }
+            if (bestYellow) {
+                kalmanRobotsYellow.push_back(*bestYellow);
             }
 
-            // Take the best kalman filter from the camera
-            for (int i = 0; i < cameraRobotsBlue.size(); i++) {
-                if (cameraRobotsBlue.at(i).size() > 0) {
-                    cameraRobotsBlue.at(i).sort([](KalmanRobot& a, KalmanRobot& b) -> bool {
-                                                       return a.getHealth() > b.getHealth();
-                                                   });
-
-                    kalmanRobotsBlue.at(i).push_back(cameraRobotsBlue.at(i).front());
-                }
+            if (bestBlue) {
+                kalmanRobotsBlue.push_back(*bestBlue);
             }
         }
-    }
 
-    // Only replace the invalid result if we have measurements on any camera
-    if (kalmanBalls.size() > 0) {
-        ball = WorldBall(calcTime, kalmanBalls);
-    }
-
-    for (int i = 0; i < robotsYellow.size(); i++) {
-        if (kalmanRobotsYellow.at(i).size() > 0) {
-            robotsYellow.at(i) = WorldRobot(calcTime, WorldRobot::Team::YELLOW, i, kalmanRobotsYellow.at(i));
+        if (kalmanRobotsYellow.size() > 0) {
+            robotsYellow.at(i) = WorldRobot(calcTime, WorldRobot::Team::YELLOW, i, std::move(kalmanRobotsYellow));
+        } else {
+            robotsYellow.at(i) = WorldRobot();
         }
-    }
 
-    for (int i = 0; i < robotsBlue.size(); i++) {
-        if (kalmanRobotsBlue.at(i).size() > 0) {
-            robotsBlue.at(i) = WorldRobot(calcTime, WorldRobot::Team::BLUE, i, kalmanRobotsBlue.at(i));
+        if (kalmanRobotsBlue.size() > 0) {
+            robotsBlue.at(i) = WorldRobot(calcTime, WorldRobot::Team::BLUE, i, std::move(kalmanRobotsBlue));
+        } else {
+            robotsBlue.at(i) = WorldRobot();
         }
     }
 }
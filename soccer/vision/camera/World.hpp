@@ -1,6 +1,8 @@
 #include <list>
+#include <memory>
 #include <vector>
 
+#include <ThreadPool.hpp>
 #include <Utils.hpp>
 #include <Configuration.hpp>
 
@@ -16,6 +18,11 @@
 
 /**
  * Keeps list of all the cameras and sends camera data down to the correct location
+ *
+ * Cameras don't share any state while they update, so when parallel camera
+ * updates are enabled each camera is updated on its own worker thread.  The
+ * merge of the cameras' filters in updateWorldObjects() runs after every
+ * camera has finished.
  */
 class World {
 public:
@@ -64,9 +71,12 @@ public:
 
 private:
     /**
-     * Does the ball bounce calculations for each of the child cameras
+     * Runs @update(camera) for each camera in @cameraIDs, on the worker
+     * threads if parallel updates are enabled.  Returns once every camera
+     * has been updated.
      */
-    void calcBallBounce();
+    template <typename F>
+    void updateCameras(const std::vector<int>& cameraIDs, F&& update);
 
     /**
      * Fills the world objects with a mix of the best kalman filters from
@@ -85,6 +95,9 @@ private:
 
     std::vector<Camera> cameras;
 
+    // Worker threads for parallel camera updates.  Created on first use.
+    std::unique_ptr<ThreadPool> threadPool;
+
     WorldBall ball;
     std::vector<WorldRobot> robotsYellow;
     std::vector<WorldRobot> robotsBlue;
@@ -100,4 +113,9 @@ private:
     // Only replace the fast kick estimate with a slow when the two times
     // are within this amount
     static ConfigDouble* same_kick_timeout;
+
+    // Update the cameras in parallel
+    static ConfigBool* parallel_camera_update;
+    // Number of threads to use for parallel camera updates
+    static ConfigInt* num_camera_threads;
 };
\ No newline at end of file
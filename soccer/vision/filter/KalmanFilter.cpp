@@ -1,33 +1,41 @@
 #include "KalmanFilter.hpp"
 
-void KalmanFilter::predict() {
+template <int StateSize, int ObservationSize>
+void KalmanFilter<StateSize, ObservationSize>::predict() {
     x_k1_k1 = x_k_k;
     P_k1_k1 = P_k_k;
 
     // Predict
-    x_k_k1 = F_k * x_k1_k1 + B_k*u_k;
-    P_k_k1 = F_k * P_k1_k1 * F_k.transpose() + Q_k;
+    x_k_k1.noalias() = F_k * x_k1_k1 + B_k*u_k;
+    P_k_k1.noalias() = F_k * P_k1_k1 * F_k.transpose() + Q_k;
 
     x_k_k = x_k_k1;
     P_k_k = P_k_k1;
 }
 
-void KalmanFilter::predictWithUpdate() {
+template <int StateSize, int ObservationSize>
+void KalmanFilter<StateSize, ObservationSize>::predictWithUpdate() {
     x_k1_k1 = x_k_k;
     P_k1_k1 = P_k_k;
 
     // Predict
-    x_k_k1 = F_k * x_k1_k1 + B_k*u_k;
-    P_k_k1 = F_k * P_k1_k1 * F_k.transpose() + Q_k;
+    x_k_k1.noalias() = F_k * x_k1_k1 + B_k*u_k;
+    P_k_k1.noalias() = F_k * P_k1_k1 * F_k.transpose() + Q_k;
 
     // Update
-    y_k_k1 = z_k - H_k * x_k_k1;
+    y_k_k1.noalias() = z_k - H_k * x_k_k1;
 
-    S_k = R_k + H_k * P_k_k1 * H_k.transpose();
-    K_k = P_k_k1 * H_k.transpose() * S_k.inverse();
+    S_k.noalias() = R_k + H_k * P_k_k1 * H_k.transpose();
+    K_k.noalias() = P_k_k1 * H_k.transpose() * S_k.inverse();
 
-    x_k_k = x_k_k1 + K_k * y_k_k1;
-    P_k_k = (I - K_k * H_k) * P_k_k1 * (I - K_k * H_k).transpose() + K_k * R_k * K_k.transpose();
+    x_k_k.noalias() = x_k_k1 + K_k * y_k_k1;
 
-    y_k_k = z_k - H_k * x_k_k;
-}
\ No newline at end of file
+    // Joseph form, which keeps P_k_k symmetric positive definite
+    const StateMatrix IKH = StateMatrix::Identity() - K_k * H_k;
+    P_k_k.noalias() = IKH * P_k_k1 * IKH.transpose() + K_k * R_k * K_k.transpose();
+
+    y_k_k.noalias() = z_k - H_k * x_k_k;
+}
+
+template class KalmanFilter<4, 2>;
+template class KalmanFilter<6, 3>;
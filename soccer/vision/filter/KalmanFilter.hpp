@@ -27,26 +27,49 @@
  * x_k1_k1 is X_(k-1, k-1)
  * x_k_k is X_(k, k)
  * etc
+ *
+ * The sizes are template parameters so every matrix is a fixed-size Eigen
+ * type.  Nothing is heap allocated and the small matrix products and the
+ * inverse of S_k are unrolled by Eigen.
+ *
+ * @tparam StateSize The size of the state vector
+ * @tparam ObservationSize The size of the observation vector
  */
+template <int StateSize, int ObservationSize>
 class KalmanFilter {
 public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    using StateVector = Eigen::Matrix<double, StateSize, 1>;
+    using StateMatrix = Eigen::Matrix<double, StateSize, StateSize>;
+    using ObservationVector = Eigen::Matrix<double, ObservationSize, 1>;
+    using ObservationMatrix =
+        Eigen::Matrix<double, ObservationSize, ObservationSize>;
+
     /**
-     * Creates a general kalman filter with the given sizes
+     * Creates a general kalman filter with every matrix set to 0
      * Use a child class to setup the specific state matricies
      * Assumes 1 input
-     *
-     * @param stateSize The size of the state vector
-     * @param observationSize The size of the observation vector
      */
-    KalmanFilter(unsigned int stateSize, unsigned int observationSize) :
-        x_k1_k1(stateSize), x_k_k1(stateSize), x_k_k(stateSize),
-        u_k(1), z_k(observationSize),
-        y_k_k1(observationSize), y_k_k(observationSize),
-        P_k1_k1(stateSize, stateSize), P_k_k1(stateSize, stateSize), P_k_k(stateSize, stateSize),
-        S_k(observationSize, observationSize), K_k(stateSize, observationSize),
-        F_k(stateSize, stateSize), B_k(stateSize, 1), H_k(observationSize, stateSize),
-        Q_k(stateSize, stateSize), R_k(observationSize, observationSize),
-        I(Eigen::MatrixXd::Identity(stateSize, stateSize)) {}
+    KalmanFilter() {
+        x_k1_k1.setZero();
+        x_k_k1.setZero();
+        x_k_k.setZero();
+        u_k.setZero();
+        z_k.setZero();
+        y_k_k1.setZero();
+        y_k_k.setZero();
+        P_k1_k1.setZero();
+        P_k_k1.setZero();
+        P_k_k.setZero();
+        S_k.setZero();
+        K_k.setZero();
+        F_k.setZero();
+        B_k.setZero();
+        H_k.setZero();
+        Q_k.setZero();
+        R_k.setZero();
+    }
 
     /**
      * Predicts without update
@@ -60,29 +83,31 @@ public:
     void predictWithUpdate();
 
 protected:
-    Eigen::VectorXd x_k1_k1;
-    Eigen::VectorXd x_k_k1;
-    Eigen::VectorXd x_k_k;
+    StateVector x_k1_k1;
+    StateVector x_k_k1;
+    StateVector x_k_k;
 
-    Eigen::VectorXd u_k;
-    Eigen::VectorXd z_k;
+    Eigen::Matrix<double, 1, 1> u_k;
+    ObservationVector z_k;
 
-    Eigen::VectorXd y_k_k1;
-    Eigen::VectorXd y_k_k;
+    ObservationVector y_k_k1;
+    ObservationVector y_k_k;
 
-    Eigen::MatrixXd P_k1_k1;
-    Eigen::MatrixXd P_k_k1;
-    Eigen::MatrixXd P_k_k;
+    StateMatrix P_k1_k1;
+    StateMatrix P_k_k1;
+    StateMatrix P_k_k;
 
-    Eigen::MatrixXd S_k;
-    Eigen::MatrixXd K_k;
+    ObservationMatrix S_k;
+    Eigen::Matrix<double, StateSize, ObservationSize> K_k;
 
-    Eigen::MatrixXd F_k;
-    Eigen::MatrixXd B_k;
-    Eigen::MatrixXd H_k;
+    StateMatrix F_k;
+    Eigen::Matrix<double, StateSize, 1> B_k;
+    Eigen::Matrix<double, ObservationSize, StateSize> H_k;
 
-    Eigen::MatrixXd Q_k;
-    Eigen::MatrixXd R_k;
+    StateMatrix Q_k;
+    ObservationMatrix R_k;
+};
 
-    Eigen::MatrixXd I;
-};
\ No newline at end of file
+// The filters used by vision are instantiated in KalmanFilter.cpp
+extern template class KalmanFilter<4, 2>;
+extern template class KalmanFilter<6, 3>;
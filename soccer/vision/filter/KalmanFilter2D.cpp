@@ -16,10 +16,10 @@ void KalmanFilter2D::createConfiguration(Configuration* cfg) {
     ball_observation_noise = new ConfigDouble(cfg, "VisionFilter/Ball/observation_noise", 2.0);
 }
 
-KalmanFilter2D::KalmanFilter2D() : KalmanFilter(1,1) {}
+KalmanFilter2D::KalmanFilter2D() {}
 
 KalmanFilter2D::KalmanFilter2D(Geometry2d::Point initPos, Geometry2d::Point initVel)
-    : KalmanFilter(4, 2) {
+    : KalmanFilter() {
 
     // States are X pos, X vel, Y pos, Y vel
     x_k1_k1 << initPos.x(),
@@ -18,11 +18,11 @@ void KalmanFilter3D::createConfiguration(Configuration* cfg) {
     orientation_scale = new ConfigDouble(cfg, "VisionFilter/Robot/orientation_scale", 1);
 }
 
-KalmanFilter3D::KalmanFilter3D() : KalmanFilter(1,1) {}
+KalmanFilter3D::KalmanFilter3D() {}
 
 KalmanFilter3D::KalmanFilter3D(Geometry2d::Point initPos, double initTheta,
                                Geometry2d::Point initVel, double initOmega)
-    : KalmanFilter(6, 3) {
+    : KalmanFilter() {
 
     // States are X pos, X vel, Y pos, Y vel, theta, omega
     x_k1_k1 << initPos.x(),
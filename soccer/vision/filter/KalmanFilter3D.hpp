@@ -4,7 +4,7 @@
 #include <Geometry2d/Point.hpp>
 #include <Configuration.hpp>
 
-class KalmanFilter3D : public KalmanFilter {
+class KalmanFilter3D : public KalmanFilter<6, 3> {
 public:
     /**
      * Creates a kalman filter with all the parameters set to 0 (F_k etc)
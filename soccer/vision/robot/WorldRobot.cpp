@@ -104,7 +104,7 @@ WorldRobot::WorldRobot(RJ::Time calcTime, Team team, int robotID, std::list<Kalm
     omega = omegaAvg;
     posCov = totalPosWeight / kalmanRobots.size();
     velCov = totalVelWeight / kalmanRobots.size();
-    robotComponents = kalmanRobots;
+    robotComponents = std::move(kalmanRobots);
 }
 
 bool WorldRobot::getIsValid() const {
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+
+#include <Geometry2d/Point.hpp>
+#include <Utils.hpp>
+
+#include "vision/camera/CameraFrame.hpp"
+
+/**
+ * A frame from each of @numCameras cameras taken at @t, each seeing the
+ * ball at @ballPos and six robots on each team
+ */
+inline std::vector<CameraFrame> cameraFrames(int numCameras, RJ::Time t,
+                                             Geometry2d::Point ballPos) {
+    std::vector<CameraFrame> frames;
+    for (int cID = 0; cID < numCameras; cID++) {
+        std::vector<CameraBall> balls = {CameraBall(t, ballPos)};
+        std::vector<CameraRobot> yellow;
+        std::vector<CameraRobot> blue;
+        for (int rID = 0; rID < 6; rID++) {
+            yellow.emplace_back(t, Geometry2d::Point(rID, 1), 0, rID);
+            blue.emplace_back(t, Geometry2d::Point(rID, -1), 0, rID);
+        }
+        frames.emplace_back(t, cID, balls, yellow, blue);
+    }
+    return frames;
+}
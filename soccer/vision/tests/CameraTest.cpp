@@ -102,4 +102,49 @@ TEST(Camera, update_with_single_frame) {
     EXPECT_NEAR(kry.at(0).front().getPos().y(), 1.25, 0.01);
     EXPECT_NEAR(kry.at(0).front().getPos().y(), 1.25, 0.01);
     EXPECT_NEAR(kry.at(0).front().getTheta(), 0.25, 0.01);
-}
\ No newline at end of file
+}
+
+TEST(Camera, best_filters) {
+    Camera c = Camera(1);
+    RJ::Time t = RJ::now();
+
+    std::vector<CameraBall> b;
+    std::vector<std::list<CameraRobot>> yr(Num_Shells);
+    std::vector<std::list<CameraRobot>> br(Num_Shells);
+    WorldBall wb;
+    std::vector<WorldRobot> wry(Num_Shells, WorldRobot());
+    std::vector<WorldRobot> wrb(Num_Shells, WorldRobot());
+
+    EXPECT_EQ(c.getBestKalmanBall(), nullptr);
+    EXPECT_EQ(c.getBestKalmanRobotsYellow().at(0), nullptr);
+
+    // Start one filter, then keep updating it while a second far away
+    // filter only gets one measurement
+    b.emplace_back(t, Geometry2d::Point(0, 0));
+    yr.at(0).emplace_back(t, Geometry2d::Point(1, 1), 0, 0);
+    c.updateWithFrame(t, b, yr, br, wb, wry, wrb);
+
+    b.emplace_back(t, Geometry2d::Point(3, 3));
+    yr.at(0).emplace_back(t, Geometry2d::Point(-3, -3), 0, 0);
+    c.updateWithFrame(t, b, yr, br, wb, wry, wrb);
+
+    b.pop_back();
+    yr.at(0).pop_back();
+    for (int i = 0; i < 3; i++) {
+        c.updateWithFrame(t, b, yr, br, wb, wry, wrb);
+    }
+
+    ASSERT_EQ(c.getKalmanBalls().size(), 2);
+    ASSERT_EQ(c.getKalmanRobotsYellow().at(0).size(), 2);
+
+    ASSERT_NE(c.getBestKalmanBall(), nullptr);
+    EXPECT_NEAR(c.getBestKalmanBall()->getPos().x(), 0, 0.01);
+    ASSERT_NE(c.getBestKalmanRobotsYellow().at(0), nullptr);
+    EXPECT_NEAR(c.getBestKalmanRobotsYellow().at(0)->getPos().x(), 1, 0.01);
+    EXPECT_EQ(c.getBestKalmanRobotsBlue().at(0), nullptr);
+
+    // Copies point at their own filters
+    Camera copy = c;
+    EXPECT_NE(copy.getBestKalmanBall(), c.getBestKalmanBall());
+    EXPECT_EQ(copy.getBestKalmanBall(), &copy.getKalmanBalls().front());
+}
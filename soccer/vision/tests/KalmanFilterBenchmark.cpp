@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <Benchmark.hpp>
+
+#include "vision/filter/KalmanFilter2D.hpp"
+#include "vision/filter/KalmanFilter3D.hpp"
+
+#include <string>
+
+using namespace Eigen;
+
+namespace {
+
+/**
+ * The filter as it was before KalmanFilter had fixed sizes, with every
+ * matrix dynamically sized.  Kept here as a baseline.
+ */
+class DynamicKalmanFilter {
+public:
+    template <typename Filter>
+    explicit DynamicKalmanFilter(const Filter& filter)
+        : x_k_k(filter.x_k_k), u_k(filter.u_k), z_k(filter.z_k),
+          P_k_k(filter.P_k_k), F_k(filter.F_k), B_k(filter.B_k),
+          H_k(filter.H_k), Q_k(filter.Q_k), R_k(filter.R_k),
+          I(MatrixXd::Identity(x_k_k.size(), x_k_k.size())) {}
+
+    void predictWithUpdate() {
+        x_k1_k1 = x_k_k;
+        P_k1_k1 = P_k_k;
+
+        x_k_k1 = F_k * x_k1_k1 + B_k * u_k;
+        P_k_k1 = F_k * P_k1_k1 * F_k.transpose() + Q_k;
+
+        y_k_k1 = z_k - H_k * x_k_k1;
+
+        S_k = R_k + H_k * P_k_k1 * H_k.transpose();
+        K_k = P_k_k1 * H_k.transpose() * S_k.inverse();
+
+        x_k_k = x_k_k1 + K_k * y_k_k1;
+        P_k_k = (I - K_k * H_k) * P_k_k1 * (I - K_k * H_k).transpose() +
+                K_k * R_k * K_k.transpose();
+
+        y_k_k = z_k - H_k * x_k_k;
+    }
+
+    VectorXd x_k1_k1, x_k_k1, x_k_k, u_k, z_k, y_k_k1, y_k_k;
+    MatrixXd P_k1_k1, P_k_k1, P_k_k, S_k, K_k, F_k, B_k, H_k, Q_k, R_k, I;
+};
+
+/// Gives the benchmark access to a filter's matrices
+template <typename Base>
+class OpenFilter : public Base {
+public:
+    using Base::Base;
+    using Base::x_k_k;
+    using Base::u_k;
+    using Base::z_k;
+    using Base::P_k_k;
+    using Base::F_k;
+    using Base::B_k;
+    using Base::H_k;
+    using Base::Q_k;
+    using Base::R_k;
+};
+
+const int Iterations = 1000000;
+
+void report(const std::string& name, double ns) {
+    Benchmark::report(name, ns);
+    printf("[ BENCH    ] %-48s %12.0f updates/s\n", name.c_str(), 1e9 / ns);
+}
+
+}  // namespace
+
+TEST(KalmanFilterBenchmark, ball) {
+    OpenFilter<KalmanFilter2D> fixed(Geometry2d::Point(1, 2),
+                                     Geometry2d::Point(0.5, -0.5));
+    DynamicKalmanFilter dynamic(fixed);
+
+    report("KalmanFilter2D (dynamic)",
+           Benchmark::nsPerIteration(Iterations, [&](int i) {
+               dynamic.z_k << 1 + i * 1e-6, 2 - i * 1e-6;
+               dynamic.predictWithUpdate();
+               Benchmark::doNotOptimize(dynamic.x_k_k(0));
+           }));
+    report("KalmanFilter2D (fixed)",
+           Benchmark::nsPerIteration(Iterations, [&](int i) {
+               fixed.predictWithUpdate(
+                   Geometry2d::Point(1 + i * 1e-6, 2 - i * 1e-6));
+               Benchmark::doNotOptimize(fixed.getPos());
+           }));
+
+    // Both should have converged to the same estimate
+    EXPECT_NEAR(dynamic.x_k_k(0), fixed.getPos().x(), 1e-6);
+    EXPECT_NEAR(dynamic.x_k_k(2), fixed.getPos().y(), 1e-6);
+}
+
+TEST(KalmanFilterBenchmark, robot) {
+    OpenFilter<KalmanFilter3D> fixed(Geometry2d::Point(1, 2), 0.5,
+                                     Geometry2d::Point(0.5, -0.5), 0.1);
+    DynamicKalmanFilter dynamic(fixed);
+
+    report("KalmanFilter3D (dynamic)",
+           Benchmark::nsPerIteration(Iterations, [&](int i) {
+               dynamic.z_k << 1 + i * 1e-6, 2 - i * 1e-6, 0.5;
+               dynamic.predictWithUpdate();
+               Benchmark::doNotOptimize(dynamic.x_k_k(0));
+           }));
+    report("KalmanFilter3D (fixed)",
+           Benchmark::nsPerIteration(Iterations, [&](int i) {
+               fixed.predictWithUpdate(
+                   Geometry2d::Point(1 + i * 1e-6, 2 - i * 1e-6), 0.5);
+               Benchmark::doNotOptimize(fixed.getPos());
+           }));
+
+    EXPECT_NEAR(dynamic.x_k_k(0), fixed.getPos().x(), 1e-6);
+    EXPECT_NEAR(dynamic.x_k_k(4), fixed.getTheta(), 1e-6);
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <Benchmark.hpp>
+
+#include "vision/VisionFilter.hpp"
+#include "vision/tests/CameraFrames.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(VisionFilterBenchmark, addFrames) {
+    VisionFilter filter;
+
+    // Push a frame from every camera at 400 Hz while the filter runs.  The
+    // frames are built ahead of time so only addFrames() is timed.
+    const int numCameras = 8;
+    const RJ::Seconds period(1.0 / 400);
+    const int numPushes = 400;
+    const Geometry2d::Point ballPos(1, 2);
+
+    double maxNs = 0;
+    double totalNs = 0;
+    RJ::Time next = RJ::now();
+    for (int i = 0; i < numPushes; i++) {
+        std::this_thread::sleep_until(next);
+        next = next + period;
+
+        const std::vector<CameraFrame> frames =
+            cameraFrames(numCameras, RJ::now(), ballPos);
+        const auto start = std::chrono::steady_clock::now();
+        filter.addFrames(frames);
+        const double ns = std::chrono::duration<double, std::nano>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+        maxNs = std::max(maxNs, ns);
+        totalNs += ns;
+    }
+
+    Benchmark::report("VisionFilter::addFrames() at 400 Hz (mean)",
+                      totalNs / numPushes);
+    Benchmark::report("VisionFilter::addFrames() at 400 Hz (max)", maxNs);
+}
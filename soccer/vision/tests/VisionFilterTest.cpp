@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "vision/VisionFilter.hpp"
+#include "vision/tests/CameraFrames.hpp"
+#include "vision/util/VisionFilterConfig.hpp"
+
+#include <thread>
+
+TEST(VisionFilter, snapshot_versions) {
+    VisionFilter filter;
+
+    std::shared_ptr<const WorldSnapshot> first = filter.snapshot();
+    ASSERT_NE(first, nullptr);
+
+    std::this_thread::sleep_for(
+        RJ::Seconds(5 * *VisionFilterConfig::vision_loop_dt));
+
+    std::shared_ptr<const WorldSnapshot> second = filter.snapshot();
+    EXPECT_GT(second->version, first->version);
+    EXPECT_FALSE(second->ball.valid);
+}
+
+TEST(VisionFilter, add_frames_stress) {
+    VisionFilter filter;
+
+    // Push a frame from every camera at 400 Hz while the filter runs.  See
+    // VisionFilterBenchmark for how long addFrames() takes.
+    const int numCameras = 8;
+    const RJ::Seconds period(1.0 / 400);
+    const int numPushes = 400;
+    const Geometry2d::Point ballPos(1, 2);
+
+    RJ::Time next = RJ::now();
+    for (int i = 0; i < numPushes; i++) {
+        std::this_thread::sleep_until(next);
+        next = next + period;
+
+        filter.addFrames(cameraFrames(numCameras, RJ::now(), ballPos));
+    }
+
+    // Let the filter take the last frames
+    std::this_thread::sleep_for(
+        RJ::Seconds(5 * *VisionFilterConfig::vision_loop_dt));
+
+    std::shared_ptr<const WorldSnapshot> world = filter.snapshot();
+    ASSERT_TRUE(world->ball.valid);
+    EXPECT_NEAR(world->ball.pos.x(), ballPos.x(), 0.01);
+    EXPECT_NEAR(world->ball.pos.y(), ballPos.y(), 0.01);
+    EXPECT_TRUE(world->robotsYellow.at(5).valid);
+    EXPECT_FALSE(world->robotsYellow.at(6).valid);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <Constants.hpp>
+#include "vision/camera/World.hpp"
+#include "vision/util/VisionFilterConfig.hpp"
+
+TEST(World, empty) {
+    World w;
+    w.updateWithoutCameraFrame(RJ::now());
+
+    EXPECT_FALSE(w.getWorldBall().getIsValid());
+    EXPECT_FALSE(w.getRobotsYellow().at(0).getIsValid());
+    EXPECT_FALSE(w.getRobotsBlue().at(0).getIsValid());
+}
+
+TEST(World, many_cameras) {
+    World w;
+    RJ::Time t = RJ::now();
+    RJ::Seconds dt(*VisionFilterConfig::vision_loop_dt);
+
+    // Every camera sees the ball and one robot of each team.  The cameras
+    // are updated in parallel, so this checks the merge sees all of them.
+    const int numCameras = 8;
+    Geometry2d::Point ballPos(1, 2);
+    for (int frame = 0; frame < 20; frame++) {
+        std::vector<CameraFrame> frames;
+        for (int cID = 0; cID < numCameras; cID++) {
+            std::vector<CameraBall> balls = {CameraBall(t, ballPos)};
+            std::vector<CameraRobot> yellow = {
+                CameraRobot(t, Geometry2d::Point(cID, 0), 0, cID)};
+            std::vector<CameraRobot> blue = {
+                CameraRobot(t, Geometry2d::Point(0, cID), 0, cID)};
+            frames.emplace_back(t, cID, balls, yellow, blue);
+        }
+
+        w.updateWithCameraFrame(t, frames);
+        t = t + dt;
+    }
+
+    // Cameras that stop sending frames are still predicted
+    w.updateWithoutCameraFrame(t);
+
+    ASSERT_TRUE(w.getWorldBall().getIsValid());
+    EXPECT_EQ(w.getWorldBall().getBallComponents().size(), numCameras);
+    EXPECT_NEAR(w.getWorldBall().getPos().x(), ballPos.x(), 0.01);
+    EXPECT_NEAR(w.getWorldBall().getPos().y(), ballPos.y(), 0.01);
+
+    for (int i = 0; i < Num_Shells; i++) {
+        EXPECT_EQ(w.getRobotsYellow().at(i).getIsValid(), i < numCameras);
+        EXPECT_EQ(w.getRobotsBlue().at(i).getIsValid(), i < numCameras);
+    }
+    EXPECT_NEAR(w.getRobotsYellow().at(3).getPos().x(), 3, 0.01);
+    EXPECT_NEAR(w.getRobotsBlue().at(3).getPos().y(), 3, 0.01);
+}